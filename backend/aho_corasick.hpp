@@ -0,0 +1,131 @@
+#ifndef AHO_CORASICK_HPP
+#define AHO_CORASICK_HPP
+
+#include <array>
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <vector>
+
+// Multi-pattern matcher compiled to a full DFA over a folded alphabet:
+// letters are lowercased, digits kept, and every other run of characters
+// becomes a single space. Patterns only match at word starts, so "rob"
+// hits "robbed" but not "probe", and multi-word phrases like "try to kill"
+// match across any whitespace or punctuation. One pass over the text
+// reports every pattern occurrence. Add all patterns, then build() once.
+class AhoCorasick {
+private:
+    static constexpr int kAlphabet = 37; // a-z, 0-9, separator
+    static constexpr int kSeparator = 36;
+
+    std::vector<std::array<int32_t, kAlphabet>> next;
+    std::vector<std::vector<int>> outputs;
+    std::vector<std::string> patterns;
+    bool built = false;
+
+    static int symbol(unsigned char ch) {
+        if (ch >= 'a' && ch <= 'z') return ch - 'a';
+        if (ch >= 'A' && ch <= 'Z') return ch - 'A';
+        if (ch >= '0' && ch <= '9') return 26 + (ch - '0');
+        return kSeparator;
+    }
+
+    int newNode() {
+        std::array<int32_t, kAlphabet> row;
+        row.fill(-1);
+        next.push_back(row);
+        outputs.emplace_back();
+        return static_cast<int>(next.size()) - 1;
+    }
+
+public:
+    AhoCorasick() {
+        newNode();
+    }
+
+    // Returns the pattern id reported by scan(), or -1 if the pattern has
+    // no letters or digits
+    int addPattern(const std::string& pattern) {
+        if (built) return -1;
+
+        // Leading separator anchors the pattern to a word start
+        std::vector<int> symbols{kSeparator};
+        for (unsigned char ch : pattern) {
+            int sym = symbol(ch);
+            if (sym == kSeparator && symbols.back() == kSeparator) continue;
+            symbols.push_back(sym);
+        }
+        if (symbols.back() == kSeparator) symbols.pop_back();
+        if (symbols.empty()) return -1;
+
+        int node = 0;
+        for (int sym : symbols) {
+            if (next[node][sym] < 0) {
+                int child = newNode();
+                next[node][sym] = child;
+            }
+            node = next[node][sym];
+        }
+
+        int id = static_cast<int>(patterns.size());
+        patterns.push_back(pattern);
+        outputs[node].push_back(id);
+        return id;
+    }
+
+    // Compute failure links and fold them into a complete transition table
+    void build() {
+        std::vector<int32_t> fail(next.size(), 0);
+        std::queue<int> bfs;
+        for (int sym = 0; sym < kAlphabet; ++sym) {
+            int child = next[0][sym];
+            if (child < 0) {
+                next[0][sym] = 0;
+            } else {
+                fail[child] = 0;
+                bfs.push(child);
+            }
+        }
+        while (!bfs.empty()) {
+            int node = bfs.front();
+            bfs.pop();
+            const auto& inherited = outputs[fail[node]];
+            outputs[node].insert(outputs[node].end(), inherited.begin(), inherited.end());
+            for (int sym = 0; sym < kAlphabet; ++sym) {
+                int child = next[node][sym];
+                if (child < 0) {
+                    next[node][sym] = next[fail[node]][sym];
+                } else {
+                    fail[child] = next[fail[node]][sym];
+                    bfs.push(child);
+                }
+            }
+        }
+        built = true;
+    }
+
+    // Calls onMatch(patternId) for every occurrence in text
+    template <typename F>
+    void scan(const std::string& text, F&& onMatch) const {
+        if (!built) return;
+        int state = next[0][kSeparator];
+        int prev = kSeparator;
+        for (unsigned char ch : text) {
+            int sym = symbol(ch);
+            if (sym == kSeparator && prev == kSeparator) continue;
+            prev = sym;
+            state = next[state][sym];
+            for (int id : outputs[state]) onMatch(id);
+        }
+    }
+
+    const std::string& pattern(int id) const {
+        return patterns[id];
+    }
+
+    size_t patternCount() const {
+        return patterns.size();
+    }
+};
+
+#endif // AHO_CORASICK_HPP
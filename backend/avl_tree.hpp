@@ -89,6 +89,50 @@ private:
         return node;
     }
 
+    AVLNode* removeNode(AVLNode* node, int key) {
+        if (!node) return nullptr;
+
+        if (key < node->key)
+            node->left = removeNode(node->left, key);
+        else if (key > node->key)
+            node->right = removeNode(node->right, key);
+        else {
+            if (!node->left || !node->right) {
+                AVLNode* child = node->left ? node->left : node->right;
+                delete node;
+                return child;
+            }
+            // Two children: take the in-order successor's entry
+            AVLNode* successor = node->right;
+            while (successor->left) successor = successor->left;
+            node->key = successor->key;
+            node->value = successor->value;
+            node->right = removeNode(node->right, successor->key);
+        }
+
+        node->height = 1 + std::max(height(node->left), height(node->right));
+
+        int balance = getBalance(node);
+
+        if (balance > 1 && getBalance(node->left) >= 0)
+            return rotateRight(node);
+
+        if (balance > 1 && getBalance(node->left) < 0) {
+            node->left = rotateLeft(node->left);
+            return rotateRight(node);
+        }
+
+        if (balance < -1 && getBalance(node->right) <= 0)
+            return rotateLeft(node);
+
+        if (balance < -1 && getBalance(node->right) > 0) {
+            node->right = rotateRight(node->right);
+            return rotateLeft(node);
+        }
+
+        return node;
+    }
+
     FIRRecord* findNode(AVLNode* node, int key) {
         if (!node) return nullptr;
         if (key == node->key) return node->value;
@@ -96,13 +140,31 @@ private:
         return findNode(node->right, key);
     }
 
+    void destroy(AVLNode* node) {
+        if (!node) return;
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+
 public:
     AVLTree() : root(nullptr) {}
 
+    ~AVLTree() {
+        destroy(root);
+    }
+
+    AVLTree(const AVLTree&) = delete;
+    AVLTree& operator=(const AVLTree&) = delete;
+
     void insert(int key, FIRRecord* value) {
         root = insertNode(root, key, value);
     }
 
+    void remove(int key) {
+        root = removeNode(root, key);
+    }
+
     FIRRecord* find(int key) {
         return findNode(root, key);
     }
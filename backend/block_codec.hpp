@@ -0,0 +1,183 @@
+#ifndef BLOCK_CODEC_HPP
+#define BLOCK_CODEC_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Byte-oriented LZ77 compression for small blocks (a few KB), in the style
+// of LZ4: no entropy coding, so decompression is a tight copy loop.
+//
+// The output is a series of sequences: a token byte (literal count in the
+// high nibble, match length - 4 in the low nibble, 15 meaning "more length
+// bytes follow"), the literals, a 2-byte little-endian back offset and any
+// extra match length bytes. The last sequence carries literals only.
+// Matches are found through a hash of the next 4 bytes, one candidate per
+// slot, within a 64 KB window.
+//
+// A preset dictionary acts as if its bytes came just before the block, so
+// back offsets may reach into it. Small blocks of similar records gain
+// most: the field names and values every record repeats are already
+// there. Both sides must use the same dictionary.
+class LZBlock {
+private:
+    static constexpr size_t kMinMatch = 4;
+    static constexpr size_t kHashBits = 13;
+    static constexpr size_t kMaxOffset = 65535;
+
+    static uint32_t load32(const uint8_t* p) {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static size_t hash(uint32_t sequence) {
+        return (sequence * 2654435761u) >> (32 - kHashBits);
+    }
+
+    static void putLength(std::vector<uint8_t>& out, size_t extra) {
+        while (extra >= 255) {
+            out.push_back(255);
+            extra -= 255;
+        }
+        out.push_back(static_cast<uint8_t>(extra));
+    }
+
+    static void emit(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalCount,
+                     size_t offset, size_t matchLength) {
+        size_t matchCode = matchLength ? matchLength - kMinMatch : 0;
+        uint8_t token = static_cast<uint8_t>((literalCount < 15 ? literalCount : 15) << 4 |
+                                             (matchCode < 15 ? matchCode : 15));
+        out.push_back(token);
+        if (literalCount >= 15) putLength(out, literalCount - 15);
+        out.insert(out.end(), literals, literals + literalCount);
+        if (!matchLength) return;
+        out.push_back(static_cast<uint8_t>(offset));
+        out.push_back(static_cast<uint8_t>(offset >> 8));
+        if (matchCode >= 15) putLength(out, matchCode - 15);
+    }
+
+    // Length field continuation; false if it runs past the input
+    static bool getLength(const uint8_t*& ip, const uint8_t* end, size_t& length) {
+        uint8_t byte;
+        do {
+            if (ip == end) return false;
+            byte = *ip++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+public:
+    // Preset dictionary; only its last 64 KB can be reached, so only those
+    // are kept. Hash slots for its positions are filled once, here.
+    class Dictionary {
+    private:
+        friend class LZBlock;
+        std::vector<uint8_t> data;
+        std::vector<uint32_t> table; // as compress() leaves it after data
+
+    public:
+        Dictionary() = default;
+
+        Dictionary(const uint8_t* bytes, size_t size) {
+            if (size > kMaxOffset) {
+                bytes += size - kMaxOffset;
+                size = kMaxOffset;
+            }
+            data.assign(bytes, bytes + size);
+            table.assign(size_t(1) << kHashBits, 0);
+            for (size_t i = 0; i + kMinMatch <= size; ++i) {
+                table[hash(load32(data.data() + i))] = static_cast<uint32_t>(i + 1);
+            }
+        }
+
+        const std::vector<uint8_t>& bytes() const {
+            return data;
+        }
+
+        bool empty() const {
+            return data.empty();
+        }
+    };
+
+    // Append the compressed form of src to out
+    static void compress(const uint8_t* src, size_t size, std::vector<uint8_t>& out,
+                         const Dictionary* dict = nullptr) {
+        // With a dictionary, match over dictionary + src as one buffer
+        std::vector<uint8_t> joined;
+        std::vector<uint32_t> table; // position + 1, 0 = empty
+        size_t start = 0;
+        if (dict && !dict->empty()) {
+            joined.reserve(dict->data.size() + size);
+            joined.assign(dict->data.begin(), dict->data.end());
+            joined.insert(joined.end(), src, src + size);
+            table = dict->table;
+            start = dict->data.size();
+            src = joined.data();
+            size = joined.size();
+        } else {
+            table.assign(size_t(1) << kHashBits, 0);
+        }
+
+        size_t anchor = start;
+        size_t i = start;
+        while (i + kMinMatch <= size) {
+            uint32_t sequence = load32(src + i);
+            size_t slot = hash(sequence);
+            size_t candidate = table[slot];
+            table[slot] = static_cast<uint32_t>(i + 1);
+            if (!candidate || i - (candidate - 1) > kMaxOffset || load32(src + candidate - 1) != sequence) {
+                ++i;
+                continue;
+            }
+            size_t match = candidate - 1;
+            size_t length = kMinMatch;
+            while (i + length < size && src[match + length] == src[i + length]) ++length;
+            emit(out, src + anchor, i - anchor, i - match, length);
+            i += length;
+            anchor = i;
+        }
+        emit(out, src + anchor, size - anchor, 0, 0);
+    }
+
+    // Decode into dst, which must hold exactly rawSize bytes; false on
+    // corrupt input
+    static bool decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t rawSize,
+                           const Dictionary* dict = nullptr) {
+        const uint8_t* history = dict ? dict->data.data() : nullptr;
+        size_t historySize = dict ? dict->data.size() : 0;
+        const uint8_t* ip = src;
+        const uint8_t* end = src + size;
+        size_t op = 0;
+        while (ip < end) {
+            uint8_t token = *ip++;
+            size_t literals = token >> 4;
+            if (literals == 15 && !getLength(ip, end, literals)) return false;
+            if (literals > static_cast<size_t>(end - ip) || literals > rawSize - op) return false;
+            std::memcpy(dst + op, ip, literals);
+            ip += literals;
+            op += literals;
+            if (ip == end) break; // last sequence
+
+            if (end - ip < 2) return false;
+            size_t offset = ip[0] | size_t(ip[1]) << 8;
+            ip += 2;
+            size_t length = token & 15;
+            if (length == 15 && !getLength(ip, end, length)) return false;
+            length += kMinMatch;
+            if (!offset || offset > op + historySize || length > rawSize - op) return false;
+            size_t k = 0;
+            if (offset > op) { // starts in the dictionary
+                size_t back = offset - op;
+                k = back < length ? back : length;
+                std::memcpy(dst + op, history + historySize - back, k);
+            }
+            for (; k < length; ++k) dst[op + k] = dst[op + k - offset]; // may overlap
+            op += length;
+        }
+        return op == rawSize;
+    }
+};
+
+#endif // BLOCK_CODEC_HPP
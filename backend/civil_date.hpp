@@ -0,0 +1,33 @@
+#ifndef CIVIL_DATE_HPP
+#define CIVIL_DATE_HPP
+
+#include <cstdint>
+#include <string>
+
+// YYYY-MM-DD dates as day and month numbers, for date indexes and
+// month buckets
+struct CivilDate {
+    // Days from civil date (Howard Hinnant's algorithm); false if not YYYY-MM-DD.
+    // outDays counts from 1970-01-01, outMonth is year * 12 + (month - 1).
+    static bool parse(const std::string& date, int32_t& outDays, int32_t& outMonth) {
+        if (date.size() < 10 || date[4] != '-' || date[7] != '-') return false;
+        for (int i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+            if (date[i] < '0' || date[i] > '9') return false;
+        }
+        int y = std::stoi(date.substr(0, 4));
+        unsigned m = static_cast<unsigned>(std::stoi(date.substr(5, 2)));
+        unsigned d = static_cast<unsigned>(std::stoi(date.substr(8, 2)));
+        if (m < 1 || m > 12 || d < 1 || d > 31) return false;
+
+        outMonth = y * 12 + static_cast<int32_t>(m - 1);
+        y -= m <= 2;
+        int era = (y >= 0 ? y : y - 399) / 400;
+        unsigned yoe = static_cast<unsigned>(y - era * 400);
+        unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        outDays = era * 146097 + static_cast<int32_t>(doe) - 719468;
+        return true;
+    }
+};
+
+#endif // CIVIL_DATE_HPP
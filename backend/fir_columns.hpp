@@ -0,0 +1,85 @@
+#ifndef FIR_COLUMNS_HPP
+#define FIR_COLUMNS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "civil_date.hpp"
+#include "query_index.hpp"
+
+// Column-store mirror of the FIR table for filter scans. Row ids are the
+// record pool slot indexes, so a row is reused when its slot is. Each
+// column is a packed array, so a scan over status, district, station or
+// date is a plain loop over contiguous memory instead of a walk over the
+// records. Status codes are intern ids; district and station codes come
+// from the store's CountedDictionary. Free text is not mirrored; the
+// record pool already holds it.
+class FIRColumns {
+public:
+    enum Column { Status, District, Station, kCodeColumns };
+
+private:
+    std::vector<uint8_t> live;
+    std::vector<uint32_t> codes[kCodeColumns];
+    std::vector<int32_t> days; // days since 1970-01-01, INT32_MIN if unknown
+
+    void ensureRow(uint32_t row) {
+        if (row < live.size()) return;
+        size_t n = static_cast<size_t>(row) + 1;
+        live.resize(n, 0);
+        for (auto& column : codes) column.resize(n, 0);
+        days.resize(n, INT32_MIN);
+    }
+
+public:
+    void put(uint32_t row, uint32_t status, uint32_t district, uint32_t station, const std::string& date) {
+        ensureRow(row);
+        live[row] = 1;
+        codes[Status][row] = status;
+        codes[District][row] = district;
+        codes[Station][row] = station;
+
+        int32_t day, month;
+        days[row] = CivilDate::parse(date, day, month) ? day : INT32_MIN;
+    }
+
+    void erase(uint32_t row) {
+        if (row < live.size()) live[row] = 0;
+    }
+
+    bool isLive(uint32_t row) const {
+        return row < live.size() && live[row];
+    }
+
+    // Only meaningful for live rows
+    uint32_t code(Column column, uint32_t row) const {
+        return codes[column][row];
+    }
+
+    int32_t day(uint32_t row) const {
+        return days[row];
+    }
+
+    // Live rows whose column holds code, ascending
+    RowList rowsWhere(Column column, uint32_t code) const {
+        const uint32_t* values = codes[column].data();
+        const uint8_t* flags = live.data();
+        RowList out;
+        for (uint32_t row = 0; row < live.size(); ++row) {
+            if ((values[row] == code) & flags[row]) out.push_back(row);
+        }
+        return out;
+    }
+
+    uint32_t rowCount() const {
+        return static_cast<uint32_t>(live.size());
+    }
+
+    size_t liveCount() const {
+        size_t n = 0;
+        for (uint8_t flag : live) n += flag;
+        return n;
+    }
+};
+
+#endif // FIR_COLUMNS_HPP
@@ -0,0 +1,468 @@
+#ifndef FIR_QUERY_HPP
+#define FIR_QUERY_HPP
+
+#include <algorithm>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+#include <json/json.h>
+#include "fir_record.hpp"
+#include "civil_date.hpp"
+#include "fir_columns.hpp"
+#include "query_index.hpp"
+#include "trie.hpp"
+
+// Predicate tree for /api/fir/query. Leaves:
+//   {"field": "status" | "district" | "policeStation" | "location", "eq": "..."}
+//   {"field": "complainant" | "suspect", "prefix": "..."}        (non-empty)
+//   {"field": "description", "contains": "words ..."}   (every word present)
+//   {"field": "date", "from": "YYYY-MM-DD", "to": "YYYY-MM-DD"}
+//   {"field": "date", "lastDays": n}
+// Combinators: {"and": [...]}, {"or": [...]}, {"not": {...}}
+struct Predicate {
+    enum class Kind { And, Or, Not, Eq, Prefix, Contains, DateRange };
+    enum class Field { None, Status, District, Station, Location, Complainant, Suspect, Description, Date };
+
+    Kind kind = Kind::And;
+    Field field = Field::None;
+    std::string value;
+    uint32_t code = 0;          // Eq: code of value, see QueryPlanner::bind
+    bool known = false;         // Eq: some record may hold value
+    int32_t from = INT32_MIN;   // DateRange, in days since epoch
+    int32_t to = INT32_MAX;
+    std::vector<std::string> terms; // Contains
+    std::vector<Predicate> children;
+
+    static bool parseDay(const Json::Value& json, int32_t& day, std::string& error) {
+        int32_t month;
+        if (!json.isString() || !CivilDate::parse(json.asString(), day, month)) {
+            error = "dates must be YYYY-MM-DD";
+            return false;
+        }
+        return true;
+    }
+
+    static bool parse(const Json::Value& json, Predicate& out, std::string& error) {
+        if (!json.isObject()) {
+            error = "predicate must be an object";
+            return false;
+        }
+        if (json.isMember("and") || json.isMember("or")) {
+            out.kind = json.isMember("and") ? Kind::And : Kind::Or;
+            const Json::Value& list = json[out.kind == Kind::And ? "and" : "or"];
+            if (!list.isArray() || list.empty()) {
+                error = "and/or takes a non-empty array";
+                return false;
+            }
+            for (const auto& item : list) {
+                out.children.emplace_back();
+                if (!parse(item, out.children.back(), error)) return false;
+            }
+            return true;
+        }
+        if (json.isMember("not")) {
+            out.kind = Kind::Not;
+            out.children.emplace_back();
+            return parse(json["not"], out.children.back(), error);
+        }
+
+        std::string field = json["field"].asString();
+        if (field == "status" || field == "district" || field == "policeStation" || field == "location") {
+            out.kind = Kind::Eq;
+            out.field = field == "status" ? Field::Status
+                      : field == "district" ? Field::District
+                      : field == "policeStation" ? Field::Station : Field::Location;
+            out.value = json["eq"].asString();
+            // Statuses are interned. District and station codes belong to
+            // the store and are bound when the query runs; locations are
+            // matched by text.
+            if (out.field == Field::Status) out.known = internTable().find(out.value, out.code);
+            else out.known = out.field == Field::Location;
+        } else if (field == "complainant" || field == "suspect") {
+            out.kind = Kind::Prefix;
+            out.field = field == "complainant" ? Field::Complainant : Field::Suspect;
+            out.value = json["prefix"].asString();
+            // The name tries index no empty prefix, while a row check would
+            // accept every name, so reject it rather than let the plan decide
+            if (out.value.empty()) {
+                error = "prefix must not be empty";
+                return false;
+            }
+        } else if (field == "description") {
+            out.kind = Kind::Contains;
+            out.field = Field::Description;
+            out.value = json["contains"].asString();
+            out.terms = TextIndex::words(out.value);
+        } else if (field == "date") {
+            out.kind = Kind::DateRange;
+            out.field = Field::Date;
+            if (json.isMember("lastDays")) {
+                int32_t today = static_cast<int32_t>(std::time(nullptr) / 86400);
+                out.from = today - json["lastDays"].asInt();
+                out.to = today;
+            }
+            if (json.isMember("from") && !parseDay(json["from"], out.from, error)) return false;
+            if (json.isMember("to") && !parseDay(json["to"], out.to, error)) return false;
+        } else {
+            error = "unknown field '" + field + "'";
+            return false;
+        }
+        return true;
+    }
+};
+
+// Indexes and row access the planner works against, supplied by FIRStore
+struct QuerySource {
+    const BitmapIndex& status;
+    const BitmapIndex& district; // keyed by districtCodes
+    const BitmapIndex& station;  // keyed by stationCodes
+    const CountedDictionary& districtCodes;
+    const CountedDictionary& stationCodes;
+    const TextBitmapIndex& location;
+    const DateIndex& dates;
+    const TextIndex& text;
+    const Trie& complainants;
+    const Trie& suspects;
+    const FIRColumns& columns;
+    std::function<const FIRRecord*(uint32_t)> recordAt; // null for free rows
+    std::function<uint32_t(int)> rowOf;                 // UINT32_MAX if unknown
+    uint32_t rowCount;
+};
+
+// Picks, for each AND, the index with the smallest estimated result as the
+// driver, intersects further postings that are small enough to be worth
+// it, probes bitmap indexes row by row, and verifies whatever is left on
+// the rows. Anything without an index falls back to a scan. Status,
+// district, station and date checks read the columns; only name and text
+// checks dereference the record.
+class QueryPlanner {
+private:
+    const QuerySource& source;
+    std::vector<std::string> steps;
+
+    static constexpr size_t kIntersectRatio = 4; // materialize if est <= ratio * candidates
+
+    static const char* fieldName(Predicate::Field field) {
+        switch (field) {
+            case Predicate::Field::Status: return "status";
+            case Predicate::Field::District: return "district";
+            case Predicate::Field::Station: return "policeStation";
+            case Predicate::Field::Location: return "location";
+            case Predicate::Field::Complainant: return "complainant";
+            case Predicate::Field::Suspect: return "suspect";
+            case Predicate::Field::Description: return "description";
+            case Predicate::Field::Date: return "date";
+            default: return "";
+        }
+    }
+
+    static std::string describe(const Predicate& p) {
+        switch (p.kind) {
+            case Predicate::Kind::And: return "and(" + std::to_string(p.children.size()) + ")";
+            case Predicate::Kind::Or: return "or(" + std::to_string(p.children.size()) + ")";
+            case Predicate::Kind::Not: return "not";
+            case Predicate::Kind::Eq: return std::string(fieldName(p.field)) + "=" + p.value;
+            case Predicate::Kind::Prefix: return std::string(fieldName(p.field)) + "^" + p.value;
+            case Predicate::Kind::Contains: return "description~" + p.value;
+            case Predicate::Kind::DateRange: return "date range";
+        }
+        return "";
+    }
+
+    // Rows of an Eq leaf; null if no row has the value
+    const RowBitmap* bitmapFor(const Predicate& p) const {
+        if (!p.known) return nullptr;
+        switch (p.field) {
+            case Predicate::Field::Status: return source.status.find(p.code);
+            case Predicate::Field::District: return source.district.find(p.code);
+            case Predicate::Field::Station: return source.station.find(p.code);
+            default: return source.location.find(p.value);
+        }
+    }
+
+    static bool fieldEquals(const FIRRecord& record, const Predicate& p) {
+        switch (p.field) {
+            case Predicate::Field::Status: return record.status.code() == p.code;
+            case Predicate::Field::District: return record.district == p.value;
+            case Predicate::Field::Station: return record.policeStation == p.value;
+            default: return record.location == p.value;
+        }
+    }
+
+    static bool startsWithIgnoreCase(const std::string& text, const std::string& prefix) {
+        if (prefix.size() > text.size()) return false;
+        for (size_t i = 0; i < prefix.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(text[i])) !=
+                std::tolower(static_cast<unsigned char>(prefix[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool indexed(const Predicate& p) const {
+        switch (p.kind) {
+            case Predicate::Kind::And:
+                return std::any_of(p.children.begin(), p.children.end(),
+                                   [this](const Predicate& c) { return indexed(c); });
+            case Predicate::Kind::Or:
+                return std::all_of(p.children.begin(), p.children.end(),
+                                   [this](const Predicate& c) { return indexed(c); });
+            case Predicate::Kind::Not: return false;
+            case Predicate::Kind::Contains: return !p.terms.empty();
+            default: return true;
+        }
+    }
+
+    // Upper bound on matching rows
+    size_t estimate(const Predicate& p) const {
+        switch (p.kind) {
+            case Predicate::Kind::Eq: {
+                const RowBitmap* bitmap = bitmapFor(p);
+                return bitmap ? bitmap->size() : 0;
+            }
+            case Predicate::Kind::Prefix:
+                return (p.field == Predicate::Field::Complainant ? source.complainants : source.suspects)
+                    .countPrefix(p.value);
+            case Predicate::Kind::Contains: {
+                if (p.terms.empty()) return source.rowCount;
+                size_t best = source.rowCount;
+                for (const auto& term : p.terms) {
+                    const RowList* rows = source.text.find(term);
+                    best = std::min(best, rows ? rows->size() : 0);
+                }
+                return best;
+            }
+            case Predicate::Kind::DateRange:
+                return source.dates.count(p.from, p.to);
+            case Predicate::Kind::And: {
+                size_t best = source.rowCount;
+                for (const auto& child : p.children) {
+                    if (indexed(child)) best = std::min(best, estimate(child));
+                }
+                return best;
+            }
+            case Predicate::Kind::Or: {
+                if (!indexed(p)) return source.rowCount;
+                size_t sum = 0;
+                for (const auto& child : p.children) sum += estimate(child);
+                return std::min<size_t>(sum, source.rowCount);
+            }
+            default:
+                return source.rowCount;
+        }
+    }
+
+    // Exact matching rows of an indexed predicate
+    RowList rows(const Predicate& p) {
+        switch (p.kind) {
+            case Predicate::Kind::Eq: {
+                const RowBitmap* bitmap = bitmapFor(p);
+                return bitmap ? bitmap->rows() : RowList();
+            }
+            case Predicate::Kind::Prefix: {
+                const Trie& trie = p.field == Predicate::Field::Complainant ? source.complainants : source.suspects;
+                RowList out;
+                for (int id : trie.startsWith(p.value)) {
+                    // reindex() moves trie entries with every name change,
+                    // so each hit is a stored record with a matching name
+                    uint32_t row = source.rowOf(id);
+                    if (row != UINT32_MAX) out.push_back(row);
+                }
+                std::sort(out.begin(), out.end());
+                out.erase(std::unique(out.begin(), out.end()), out.end());
+                return out;
+            }
+            case Predicate::Kind::Contains: {
+                std::vector<const RowList*> lists;
+                for (const auto& term : p.terms) {
+                    const RowList* list = source.text.find(term);
+                    if (!list) return RowList();
+                    lists.push_back(list);
+                }
+                std::sort(lists.begin(), lists.end(), [](const RowList* a, const RowList* b) {
+                    return a->size() < b->size();
+                });
+                RowList out = *lists[0];
+                for (size_t i = 1; i < lists.size() && !out.empty(); ++i) {
+                    out = intersectRows(out, *lists[i]);
+                }
+                return out;
+            }
+            case Predicate::Kind::DateRange:
+                return source.dates.rows(p.from, p.to);
+            case Predicate::Kind::And:
+                return planAnd(p);
+            case Predicate::Kind::Or: {
+                RowList out;
+                for (const auto& child : p.children) {
+                    out = unionRows(out, rows(child));
+                }
+                steps.push_back("union " + describe(p));
+                return out;
+            }
+            default:
+                return RowList();
+        }
+    }
+
+    RowList planAnd(const Predicate& p) {
+        std::vector<std::pair<size_t, const Predicate*>> driven;
+        std::vector<const Predicate*> verify;
+        for (const auto& child : p.children) {
+            if (indexed(child)) driven.emplace_back(estimate(child), &child);
+            else verify.push_back(&child);
+        }
+        std::sort(driven.begin(), driven.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+
+        RowList candidates = rows(*driven[0].second);
+        steps.push_back("index " + describe(*driven[0].second) + " (est " +
+                        std::to_string(driven[0].first) + ", got " + std::to_string(candidates.size()) + ")");
+
+        for (size_t i = 1; i < driven.size(); ++i) {
+            const Predicate& child = *driven[i].second;
+            if (candidates.empty()) break;
+            if (child.kind == Predicate::Kind::Eq) {
+                const RowBitmap* bitmap = bitmapFor(child);
+                RowList kept;
+                for (uint32_t row : candidates) {
+                    if (bitmap && bitmap->test(row)) kept.push_back(row);
+                }
+                candidates.swap(kept);
+                steps.push_back("probe " + describe(child) + " bitmap -> " + std::to_string(candidates.size()));
+            } else if (driven[i].first <= kIntersectRatio * candidates.size()) {
+                candidates = intersectRows(candidates, rows(child));
+                steps.push_back("intersect " + describe(child) + " (est " +
+                                std::to_string(driven[i].first) + ") -> " + std::to_string(candidates.size()));
+            } else {
+                verify.push_back(&child);
+            }
+        }
+
+        if (!verify.empty() && !candidates.empty()) {
+            RowList kept;
+            for (uint32_t row : candidates) {
+                bool ok = source.columns.isLive(row);
+                for (size_t v = 0; ok && v < verify.size(); ++v) {
+                    ok = matchesRow(*verify[v], row);
+                }
+                if (ok) kept.push_back(row);
+            }
+            candidates.swap(kept);
+            for (const Predicate* child : verify) {
+                steps.push_back("verify " + describe(*child));
+            }
+        }
+        return candidates;
+    }
+
+    // matches() for a live row, answering column predicates from the
+    // columns
+    bool matchesRow(const Predicate& p, uint32_t row) const {
+        switch (p.kind) {
+            case Predicate::Kind::And:
+                for (const auto& child : p.children) {
+                    if (!matchesRow(child, row)) return false;
+                }
+                return true;
+            case Predicate::Kind::Or:
+                for (const auto& child : p.children) {
+                    if (matchesRow(child, row)) return true;
+                }
+                return false;
+            case Predicate::Kind::Not:
+                return !matchesRow(p.children[0], row);
+            case Predicate::Kind::Eq:
+                switch (p.field) {
+                    case Predicate::Field::Status: return p.known && source.columns.code(FIRColumns::Status, row) == p.code;
+                    case Predicate::Field::District: return p.known && source.columns.code(FIRColumns::District, row) == p.code;
+                    case Predicate::Field::Station: return p.known && source.columns.code(FIRColumns::Station, row) == p.code;
+                    default: break;
+                }
+                break;
+            case Predicate::Kind::DateRange: {
+                int32_t day = source.columns.day(row);
+                return day != INT32_MIN && day >= p.from && day <= p.to;
+            }
+            default:
+                break;
+        }
+        const FIRRecord* record = source.recordAt(row);
+        return record && matches(p, *record);
+    }
+
+public:
+    explicit QueryPlanner(const QuerySource& src) : source(src) {}
+
+    static bool matches(const Predicate& p, const FIRRecord& record) {
+        switch (p.kind) {
+            case Predicate::Kind::And:
+                for (const auto& child : p.children) {
+                    if (!matches(child, record)) return false;
+                }
+                return true;
+            case Predicate::Kind::Or:
+                for (const auto& child : p.children) {
+                    if (matches(child, record)) return true;
+                }
+                return false;
+            case Predicate::Kind::Not:
+                return !matches(p.children[0], record);
+            case Predicate::Kind::Eq:
+                return p.known && fieldEquals(record, p);
+            case Predicate::Kind::Prefix:
+                return startsWithIgnoreCase(p.field == Predicate::Field::Complainant ? record.complainant : record.suspect,
+                                            p.value);
+            case Predicate::Kind::Contains: {
+                std::vector<std::string> words = TextIndex::words(record.description);
+                return std::includes(words.begin(), words.end(), p.terms.begin(), p.terms.end());
+            }
+            case Predicate::Kind::DateRange: {
+                int32_t day, month;
+                return CivilDate::parse(record.date, day, month) && day >= p.from && day <= p.to;
+            }
+        }
+        return false;
+    }
+
+    // Resolve district and station values to the store's codes
+    void bind(Predicate& p) const {
+        for (auto& child : p.children) bind(child);
+        if (p.kind != Predicate::Kind::Eq) return;
+        const CountedDictionary* codes = p.field == Predicate::Field::District ? &source.districtCodes
+                                       : p.field == Predicate::Field::Station ? &source.stationCodes : nullptr;
+        if (!codes) return;
+        p.code = codes->find(p.value);
+        p.known = p.code != CountedDictionary::kMissing;
+    }
+
+    // Matching rows in ascending row order
+    RowList run(const Predicate& predicate) {
+        steps.clear();
+        Predicate p = predicate;
+        bind(p);
+        if (indexed(p)) {
+            RowList out = rows(p);
+            if (p.kind != Predicate::Kind::And && p.kind != Predicate::Kind::Or) {
+                steps.push_back("index " + describe(p) + " -> " + std::to_string(out.size()));
+            }
+            return out;
+        }
+
+        steps.push_back("scan " + std::to_string(source.rowCount) + " rows, verify " + describe(p));
+        RowList out;
+        for (uint32_t row = 0; row < source.rowCount; ++row) {
+            if (source.columns.isLive(row) && matchesRow(p, row)) out.push_back(row);
+        }
+        return out;
+    }
+
+    const std::vector<std::string>& plan() const {
+        return steps;
+    }
+};
+
+#endif // FIR_QUERY_HPP
@@ -2,19 +2,42 @@
 #define FIR_RECORD_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <json/json.h>
+#include "ipc_catalog.hpp"
+#include "intern_table.hpp"
+
+inline Json::Value jsonText(std::string_view text) {
+    return Json::Value(text.data(), text.data() + text.size());
+}
+
+// The statuses a FIR can take. Interned text is never freed, so only
+// closed vocabularies like this one are interned; handlers reject others.
+inline constexpr std::string_view kFIRStatuses[] = {"open", "closed", "under_investigation"};
+
+inline bool isKnownStatus(std::string_view status) {
+    for (std::string_view known : kFIRStatuses) {
+        if (status == known) return true;
+    }
+    return false;
+}
 
 struct FIRRecord {
     int id;
     std::string complainant;
     std::string suspect;
     std::string date;
-    std::string location;
+    std::string location; // free text: not interned
     std::string description;
-    std::string status;
+    InternedString status;
     std::vector<std::string> tags;
     std::vector<int> relatedIds;
+    std::string suspectPhone;
+    std::string suspectAddress;
+    std::string district;      // open vocabularies: not interned
+    std::string policeStation;
+    std::vector<InternedString> ipcSections; // handlers admit catalog sections only
 
     Json::Value toJson() const {
         Json::Value json;
@@ -24,7 +47,7 @@ struct FIRRecord {
         json["date"] = date;
         json["location"] = location;
         json["description"] = description;
-        json["status"] = status;
+        json["status"] = jsonText(status.view());
         
         Json::Value tagsArray(Json::arrayValue);
         for (const auto& tag : tags) {
@@ -37,6 +60,16 @@ struct FIRRecord {
             relatedArray.append(relId);
         }
         json["relatedIds"] = relatedArray;
+        json["suspectPhone"] = suspectPhone;
+        json["suspectAddress"] = suspectAddress;
+        json["district"] = district;
+        json["policeStation"] = policeStation;
+
+        Json::Value sectionsArray(Json::arrayValue);
+        for (const auto& section : ipcSections) {
+            sectionsArray.append(jsonText(section.view()));
+        }
+        json["ipcSections"] = sectionsArray;
         
         return json;
     }
@@ -58,33 +91,60 @@ struct FIRRecord {
         for (const auto& relId : json["relatedIds"]) {
             record.relatedIds.push_back(relId.asInt());
         }
+        record.suspectPhone = json.get("suspectPhone", "").asString();
+        record.suspectAddress = json.get("suspectAddress", "").asString();
+        record.district = json.get("district", "").asString();
+        record.policeStation = json.get("policeStation", "").asString();
+        for (const auto& section : json["ipcSections"]) {
+            record.ipcSections.push_back(section.asString());
+        }
         
         return record;
     }
-};
-
-struct IPCSection {
-    std::string section;
-    std::string title;
-    std::string description;
-    std::vector<std::string> keywords;
-    std::string punishment;
 
-    Json::Value toJson() const {
-        Json::Value json;
-        json["section"] = section;
-        json["title"] = title;
-        json["description"] = description;
-        json["punishment"] = punishment;
-        
-        Json::Value keywordsArray(Json::arrayValue);
-        for (const auto& kw : keywords) {
-            keywordsArray.append(kw);
+    // Overwrite only the fields present in json (a partial update); id is
+    // left alone
+    void applyJson(const Json::Value& json) {
+        if (json.isMember("complainant")) complainant = json["complainant"].asString();
+        if (json.isMember("suspect")) suspect = json["suspect"].asString();
+        if (json.isMember("date")) date = json["date"].asString();
+        if (json.isMember("location")) location = json["location"].asString();
+        if (json.isMember("description")) description = json["description"].asString();
+        if (json.isMember("status")) status = json["status"].asString();
+        if (json.isMember("suspectPhone")) suspectPhone = json["suspectPhone"].asString();
+        if (json.isMember("suspectAddress")) suspectAddress = json["suspectAddress"].asString();
+        if (json.isMember("district")) district = json["district"].asString();
+        if (json.isMember("policeStation")) policeStation = json["policeStation"].asString();
+        if (json.isMember("tags")) {
+            tags.clear();
+            for (const auto& tag : json["tags"]) tags.push_back(tag.asString());
+        }
+        if (json.isMember("relatedIds")) {
+            relatedIds.clear();
+            for (const auto& relId : json["relatedIds"]) relatedIds.push_back(relId.asInt());
+        }
+        if (json.isMember("ipcSections")) {
+            ipcSections.clear();
+            for (const auto& section : json["ipcSections"]) ipcSections.push_back(section.asString());
         }
-        json["keywords"] = keywordsArray;
-        
-        return json;
     }
 };
 
+inline Json::Value toJson(const IPCSection& section) {
+    Json::Value json;
+    json["section"] = jsonText(section.section);
+    json["title"] = jsonText(section.title);
+    json["description"] = jsonText(section.description);
+    json["punishment"] = jsonText(section.punishment);
+    json["act"] = jsonText(section.act);
+    
+    Json::Value keywordsArray(Json::arrayValue);
+    for (size_t k = 0; k < section.keywordCount; ++k) {
+        keywordsArray.append(jsonText(section.keywords[k]));
+    }
+    json["keywords"] = keywordsArray;
+    
+    return json;
+}
+
 #endif // FIR_RECORD_HPP
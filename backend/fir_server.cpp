@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 #include <unordered_map>
 #include <memory>
 #include <fstream>
@@ -19,8 +20,34 @@
 #include <ctime>
 #include <iomanip>
 #include <regex>
+#include <random>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <atomic>
+#include <filesystem>
+#include <cstdio>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 #include "httplib.h" // Simple HTTP library for C++
 #include "json.hpp"  // JSON library for C++
+#include "ipc_catalog.hpp"
+#include "ipc_suggester.hpp"
+#include "ipc_classifier.hpp"
+#include "intern_table.hpp"
+#include "text_search.hpp"
+#include "rate_counter.hpp"
+#include "minhash.hpp"
+#include "object_pool.hpp"
+#include "page_file.hpp"
+#include "lsm_store.hpp"
+#include "record_file.hpp"
 
 using json = nlohmann::json;
 using namespace std;
@@ -30,12 +57,21 @@ using namespace httplib;
 // Data Structures (From OOP Concepts)
 // ========================================
 
+// Interned fields serialize as their text
+void to_json(json& j, const InternedString& value) {
+    j = string(value.view());
+}
+
+void from_json(const json& j, InternedString& value) {
+    value = InternedString(j.get<string>());
+}
+
 /**
  * FIR Record - Core data structure
  */
 struct FIRRecord {
     string id;
-    string district;
+    string district;       // open vocabularies, stored as plain text
     string policeStation;
     string complainantName;
     string complainantFatherName;
@@ -51,9 +87,18 @@ struct FIRRecord {
     string suspectAddress;
     string suspectDescription;
     string propertyDescription;
-    vector<string> ipcSections;
+    vector<InternedString> ipcSections;
+    InternedString ipcSectionsSource; // "officer" or "suggested"; checked before interning
     string timestamp;
-    string status; // "pending", "under_investigation", "closed"
+    InternedString status; // "pending", "under_investigation", "closed"; checked before interning
+    
+    vector<string> ipcSectionList() const {
+        vector<string> list;
+        for (const auto& section : ipcSections) {
+            list.push_back(section.str());
+        }
+        return list;
+    }
     
     // Convert to JSON
     json toJSON() const {
@@ -76,6 +121,7 @@ struct FIRRecord {
         j["suspectDescription"] = suspectDescription;
         j["propertyDescription"] = propertyDescription;
         j["ipcSections"] = ipcSections;
+        j["ipcSectionsSource"] = ipcSectionsSource;
         j["timestamp"] = timestamp;
         j["status"] = status;
         return j;
@@ -102,51 +148,88 @@ struct FIRRecord {
         fir.suspectDescription = j.value("suspectDescription", "");
         fir.propertyDescription = j.value("propertyDescription", "");
         if (j.contains("ipcSections") && j["ipcSections"].is_array()) {
-            fir.ipcSections = j["ipcSections"].get<vector<string>>();
+            fir.ipcSections = j["ipcSections"].get<vector<InternedString>>();
         }
+        fir.ipcSectionsSource = j.value("ipcSectionsSource", "officer");
         fir.timestamp = j.value("timestamp", "");
         fir.status = j.value("status", "pending");
         return fir;
     }
+    
+    // Overwrite only the fields present in j; id and timestamp are fixed
+    void applyJSON(const json& j) {
+        auto text = [&j](const char* key, string& field) {
+            if (j.contains(key)) field = j[key].get<string>();
+        };
+        auto interned = [&j](const char* key, InternedString& field) {
+            if (j.contains(key)) field = j[key].get<string>();
+        };
+        text("district", district);
+        text("policeStation", policeStation);
+        text("complainantName", complainantName);
+        text("complainantFatherName", complainantFatherName);
+        text("complainantAddress", complainantAddress);
+        text("complainantPhone", complainantPhone);
+        text("complainantEmail", complainantEmail);
+        text("dateOfIncident", dateOfIncident);
+        text("timeOfIncident", timeOfIncident);
+        text("placeOfIncident", placeOfIncident);
+        text("incidentDescription", incidentDescription);
+        text("suspectName", suspectName);
+        text("suspectAge", suspectAge);
+        text("suspectAddress", suspectAddress);
+        text("suspectDescription", suspectDescription);
+        text("propertyDescription", propertyDescription);
+        if (j.contains("ipcSections") && j["ipcSections"].is_array()) {
+            ipcSections = j["ipcSections"].get<vector<InternedString>>();
+            ipcSectionsSource = "officer";
+        }
+        interned("status", status);
+    }
 };
 
 /**
  * AVL Tree Node for Fast FIR Search
- * Time Complexity: O(log n) for search, insert, delete
+ * Points at an id string owned by FIRTable, wherever the record lives
  */
 struct AVLNode {
-    FIRRecord data;
+    const string* id;
     int height;
-    shared_ptr<AVLNode> left;
-    shared_ptr<AVLNode> right;
+    AVLNode* left;
+    AVLNode* right;
     
-    AVLNode(const FIRRecord& fir) : data(fir), height(1), left(nullptr), right(nullptr) {}
+    explicit AVLNode(const string* key) : id(key), height(1), left(nullptr), right(nullptr) {}
 };
 
 /**
- * AVL Tree Implementation
+ * AVL Tree Implementation - ordered index over FIR ids
+ * Time Complexity: O(log n) for search, insert, delete
  */
 class AVLTree {
 private:
-    shared_ptr<AVLNode> root;
+    AVLNode* root;
+    
+    static const string& key(const AVLNode* node) {
+        return *node->id;
+    }
     
-    int getHeight(shared_ptr<AVLNode> node) {
+    int getHeight(AVLNode* node) {
         return node ? node->height : 0;
     }
     
-    int getBalance(shared_ptr<AVLNode> node) {
+    int getBalance(AVLNode* node) {
         return node ? getHeight(node->left) - getHeight(node->right) : 0;
     }
     
-    void updateHeight(shared_ptr<AVLNode> node) {
+    void updateHeight(AVLNode* node) {
         if (node) {
             node->height = 1 + max(getHeight(node->left), getHeight(node->right));
         }
     }
     
-    shared_ptr<AVLNode> rotateRight(shared_ptr<AVLNode> y) {
-        auto x = y->left;
-        auto T2 = x->right;
+    AVLNode* rotateRight(AVLNode* y) {
+        AVLNode* x = y->left;
+        AVLNode* T2 = x->right;
         x->right = y;
         y->left = T2;
         updateHeight(y);
@@ -154,9 +237,9 @@ private:
         return x;
     }
     
-    shared_ptr<AVLNode> rotateLeft(shared_ptr<AVLNode> x) {
-        auto y = x->right;
-        auto T2 = y->left;
+    AVLNode* rotateLeft(AVLNode* x) {
+        AVLNode* y = x->right;
+        AVLNode* T2 = y->left;
         y->left = x;
         x->right = T2;
         updateHeight(x);
@@ -164,75 +247,277 @@ private:
         return y;
     }
     
-    shared_ptr<AVLNode> insert(shared_ptr<AVLNode> node, const FIRRecord& fir) {
-        if (!node) return make_shared<AVLNode>(fir);
-        
-        if (fir.id < node->data.id)
-            node->left = insert(node->left, fir);
-        else if (fir.id > node->data.id)
-            node->right = insert(node->right, fir);
-        else
-            return node; // Duplicate ID
-        
+    AVLNode* rebalance(AVLNode* node) {
         updateHeight(node);
         int balance = getBalance(node);
         
-        // Left Left
-        if (balance > 1 && fir.id < node->left->data.id)
-            return rotateRight(node);
-        
-        // Right Right
-        if (balance < -1 && fir.id > node->right->data.id)
-            return rotateLeft(node);
-        
-        // Left Right
-        if (balance > 1 && fir.id > node->left->data.id) {
-            node->left = rotateLeft(node->left);
+        if (balance > 1) {
+            if (getBalance(node->left) < 0) node->left = rotateLeft(node->left);
             return rotateRight(node);
         }
-        
-        // Right Left
-        if (balance < -1 && fir.id < node->right->data.id) {
-            node->right = rotateRight(node->right);
+        if (balance < -1) {
+            if (getBalance(node->right) > 0) node->right = rotateRight(node->right);
             return rotateLeft(node);
         }
-        
         return node;
     }
     
-    shared_ptr<AVLNode> search(shared_ptr<AVLNode> node, const string& id) {
-        if (!node || node->data.id == id)
-            return node;
+    AVLNode* insert(AVLNode* node, const string* id) {
+        if (!node) return new AVLNode(id);
         
-        if (id < node->data.id)
-            return search(node->left, id);
+        if (*id < key(node))
+            node->left = insert(node->left, id);
+        else if (*id > key(node))
+            node->right = insert(node->right, id);
+        else {
+            node->id = id; // same key, new owner of the string
+            return node;
+        }
+        return rebalance(node);
+    }
+    
+    AVLNode* remove(AVLNode* node, const string& id) {
+        if (!node) return node;
         
-        return search(node->right, id);
+        if (id < key(node))
+            node->left = remove(node->left, id);
+        else if (id > key(node))
+            node->right = remove(node->right, id);
+        else {
+            if (!node->left || !node->right) {
+                AVLNode* child = node->left ? node->left : node->right;
+                delete node;
+                return child;
+            }
+            // Two children: take the in-order successor's id
+            AVLNode* successor = node->right;
+            while (successor->left) successor = successor->left;
+            node->id = successor->id;
+            node->right = remove(node->right, key(successor));
+        }
+        return rebalance(node);
+    }
+    
+    template <typename F>
+    void inorder(const AVLNode* node, F& visit) const {
+        if (!node) return;
+        inorder(node->left, visit);
+        visit(key(node));
+        inorder(node->right, visit);
     }
     
-    void inorder(shared_ptr<AVLNode> node, vector<FIRRecord>& result) {
+    void destroy(AVLNode* node) {
         if (!node) return;
-        inorder(node->left, result);
-        result.push_back(node->data);
-        inorder(node->right, result);
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
     }
     
 public:
     AVLTree() : root(nullptr) {}
     
-    void insert(const FIRRecord& fir) {
-        root = insert(root, fir);
+    ~AVLTree() {
+        destroy(root);
     }
     
-    FIRRecord* search(const string& id) {
-        auto node = search(root, id);
-        return node ? &node->data : nullptr;
+    AVLTree(const AVLTree&) = delete;
+    AVLTree& operator=(const AVLTree&) = delete;
+    
+    // Add id, or repoint an equal key at this string
+    void insert(const string* id) {
+        root = insert(root, id);
     }
     
-    vector<FIRRecord> getAllRecords() {
-        vector<FIRRecord> result;
-        inorder(root, result);
-        return result;
+    void remove(const string& id) {
+        root = remove(root, id);
+    }
+    
+    bool contains(const string& id) const {
+        const AVLNode* node = root;
+        while (node && key(node) != id) {
+            node = id < key(node) ? node->left : node->right;
+        }
+        return node != nullptr;
+    }
+    
+    // Visit ids in order
+    template <typename F>
+    void forEach(F visit) const {
+        inorder(root, visit);
+    }
+};
+
+/**
+ * FIR Table - the single home of every FIR record
+ * Hot records live once in a slab pool, so their addresses never change;
+ * the hash index (keyed by a view of the record's own id) and the AVL tree
+ * hold references, not copies. Once tiering is enabled, records the cold
+ * predicate picks are written to a page file and dropped from memory:
+ * only their id and file extent stay resident, and reading one back goes
+ * through the page file's LRU cache, costing at most one pread.
+ * Time Complexity: O(1) average lookup by id, O(log n) ordered insert/delete
+ */
+class FIRTable {
+public:
+    // A hot Ref points into the table and is valid while the caller holds
+    // the FIRSystem lock; a cold Ref owns a copy decoded from disk
+    using Ref = shared_ptr<const FIRRecord>;
+    
+    struct Stats {
+        size_t hot = 0;
+        size_t cold = 0;
+        PageFile::Stats pages;
+    };
+    
+private:
+    using Pool = ObjectPool<FIRRecord>;
+    
+    Pool records;                                     // hot bodies
+    unordered_map<string_view, Pool::Handle> byId;    // hot, keyed by the record's own id
+    unordered_map<string, PageFile::Extent> coldById; // cold, body in the page file
+    AVLTree ordered;                                  // every id, hot or cold
+    PageFile coldPages;
+    function<bool(const FIRRecord&)> isCold;
+    
+    static Ref borrow(const FIRRecord* record) {
+        return Ref(Ref(), record); // aliasing constructor: owns nothing
+    }
+    
+    FIRRecord* findHot(const string& id) const {
+        auto it = byId.find(id);
+        return it != byId.end() ? records.get(it->second) : nullptr;
+    }
+    
+    Ref load(const PageFile::Extent& where, bool cache) const {
+        vector<uint8_t> body;
+        if (!coldPages.read(where, body, cache)) {
+            throw runtime_error("cold FIR page read failed");
+        }
+        return make_shared<const FIRRecord>(FIRRecord::fromJSON(json::from_msgpack(body)));
+    }
+    
+    // Overwrite a stored record's fields. The id string is moved back
+    // into place so the views keying byId stay valid.
+    void replace(FIRRecord* stored, FIRRecord next) {
+        next.id = move(stored->id);
+        *stored = move(next);
+    }
+    
+    // Write a hot record to the page file and free it. The Ref returned
+    // owns the body; if the write fails the record simply stays hot.
+    Ref demote(FIRRecord* stored) {
+        PageFile::Extent where;
+        if (!coldPages.append(json::to_msgpack(stored->toJSON()), where)) return borrow(stored);
+        auto hot = byId.find(stored->id);
+        Pool::Handle handle = hot->second;
+        auto cold = coldById.emplace(stored->id, where).first;
+        ordered.insert(&cold->first);
+        byId.erase(hot);
+        Ref copy = make_shared<const FIRRecord>(move(*stored));
+        records.release(handle);
+        return copy;
+    }
+    
+public:
+    // Page records matching cold out to path, caching up to cacheBytes of
+    // pages. Call once, before records are stored or right after loading.
+    bool enableTiering(const string& path, size_t cacheBytes,
+                       function<bool(const FIRRecord&)> cold, string& error) {
+        if (coldPages.isOpen()) {
+            error = "tiering already enabled";
+            return false;
+        }
+        if (!coldPages.open(path, cacheBytes, error)) return false;
+        isCold = move(cold);
+        demoteCold();
+        return true;
+    }
+    
+    // Page out hot records that have turned cold since they were written
+    size_t demoteCold() {
+        if (!isCold) return 0;
+        vector<FIRRecord*> cold;
+        records.forEach([&](FIRRecord& fir) {
+            if (isCold(fir)) cold.push_back(&fir);
+        });
+        size_t before = coldById.size();
+        for (FIRRecord* fir : cold) demote(fir);
+        return coldById.size() - before;
+    }
+    
+    Ref get(const string& id) const {
+        if (const FIRRecord* hot = findHot(id)) return borrow(hot);
+        auto cold = coldById.find(id);
+        return cold != coldById.end() ? load(cold->second, true) : nullptr;
+    }
+    
+    bool contains(const string& id) const {
+        return byId.count(id) || coldById.count(id);
+    }
+    
+    // Store a new record, or overwrite the one with the same id; it ends
+    // up hot or cold by the tiering predicate
+    Ref put(FIRRecord fir) {
+        FIRRecord* stored = findHot(fir.id);
+        if (stored) {
+            replace(stored, move(fir));
+        } else {
+            Pool::Handle handle = records.emplace(move(fir));
+            stored = records.get(handle);
+            byId.emplace(stored->id, handle);
+            ordered.insert(&stored->id);
+            auto cold = coldById.find(stored->id);
+            if (cold != coldById.end()) {
+                coldPages.release(cold->second);
+                coldById.erase(cold);
+            }
+        }
+        if (isCold && isCold(*stored)) return demote(stored);
+        return borrow(stored);
+    }
+    
+    bool erase(const string& id) {
+        auto hot = byId.find(id);
+        if (hot != byId.end()) {
+            Pool::Handle handle = hot->second;
+            ordered.remove(id);
+            byId.erase(hot);
+            records.release(handle);
+            return true;
+        }
+        auto cold = coldById.find(id);
+        if (cold == coldById.end()) return false;
+        ordered.remove(id);
+        coldPages.release(cold->second);
+        coldById.erase(cold);
+        return true;
+    }
+    
+    // Visit records in id order; cold ones are read past the cache so a
+    // full scan does not evict the working set
+    template <typename F>
+    void forEachOrdered(F visit) const {
+        ordered.forEach([&](const string& id) {
+            if (const FIRRecord* hot = findHot(id)) {
+                visit(*hot);
+            } else {
+                visit(*load(coldById.at(id), false));
+            }
+        });
+    }
+    
+    // Visit ids in order without reading any record
+    template <typename F>
+    void forEachId(F visit) const {
+        ordered.forEach(visit);
+    }
+    
+    size_t size() const {
+        return records.size() + coldById.size();
+    }
+    
+    Stats stats() const {
+        return Stats{records.size(), coldById.size(), coldPages.stats()};
     }
 };
 
@@ -242,9 +527,10 @@ public:
 struct TrieNode {
     unordered_map<char, shared_ptr<TrieNode>> children;
     bool isEndOfWord;
+    int wordCount; // FIRs using this word, so a shared name outlives one delete
     vector<string> suggestions;
     
-    TrieNode() : isEndOfWord(false) {}
+    TrieNode() : isEndOfWord(false), wordCount(0) {}
 };
 
 /**
@@ -279,6 +565,19 @@ public:
             node = node->children[ch];
         }
         node->isEndOfWord = true;
+        node->wordCount++;
+    }
+    
+    void remove(const string& word) {
+        auto node = root;
+        for (char ch : word) {
+            auto it = node->children.find(ch);
+            if (it == node->children.end()) return;
+            node = it->second;
+        }
+        if (node->wordCount > 0 && --node->wordCount == 0) {
+            node->isEndOfWord = false;
+        }
     }
     
     vector<string> autocomplete(const string& prefix) {
@@ -296,28 +595,360 @@ public:
     }
 };
 
+/**
+ * Exact-match hash index from a normalized contact value to FIR ids
+ * Time Complexity: O(1) average for add, remove and lookup
+ */
+class ContactIndex {
+private:
+    unordered_map<string, vector<string>> ids;
+    
+public:
+    // Digits only, keeping the last 10 so "+91 98765-43210" == "9876543210"
+    static string normalizePhone(const string& phone) {
+        string digits;
+        for (char ch : phone) {
+            if (isdigit(static_cast<unsigned char>(ch))) digits.push_back(ch);
+        }
+        return digits.size() > 10 ? digits.substr(digits.size() - 10) : digits;
+    }
+    
+    // Trimmed and lowercased
+    static string normalizeEmail(const string& email) {
+        size_t begin = email.find_first_not_of(" \t");
+        size_t end = email.find_last_not_of(" \t");
+        if (begin == string::npos) return "";
+        string result = email.substr(begin, end - begin + 1);
+        transform(result.begin(), result.end(), result.begin(), ::tolower);
+        return result;
+    }
+    
+    void add(const string& key, const string& id) {
+        if (key.empty()) return;
+        vector<string>& list = ids[key];
+        if (std::find(list.begin(), list.end(), id) == list.end()) list.push_back(id);
+    }
+    
+    void remove(const string& key, const string& id) {
+        auto it = ids.find(key);
+        if (it == ids.end()) return;
+        it->second.erase(std::remove(it->second.begin(), it->second.end(), id), it->second.end());
+        if (it->second.empty()) ids.erase(it);
+    }
+    
+    const vector<string>& find(const string& key) const {
+        static const vector<string> none;
+        auto it = ids.find(key);
+        return it != ids.end() ? it->second : none;
+    }
+};
+
+/**
+ * District -> Police Station -> FIR ids, with status counts on every node
+ * Counts are kept up to date on insert, remove and status change, so a
+ * district rollup is O(1) and a station listing is O(k) in its FIRs.
+ */
+class JurisdictionIndex {
+public:
+    // "FIR-9" before "FIR-10": shorter ids first, then lexicographic
+    struct IdOrder {
+        bool operator()(const string& a, const string& b) const {
+            return a.size() != b.size() ? a.size() < b.size() : a < b;
+        }
+    };
+    
+    struct Counts {
+        size_t total = 0;
+        unordered_map<uint32_t, size_t> byStatus; // status intern id -> FIRs
+        
+        void add(const InternedString& status, long delta) {
+            total += delta;
+            size_t& n = byStatus[status.code()];
+            n += delta;
+            if (n == 0) byStatus.erase(status.code());
+        }
+        
+        json toJSON() const {
+            json statuses = json::object();
+            for (const auto& [code, n] : byStatus) {
+                statuses[string(internTable().lookup(code))] = n;
+            }
+            return {{"total", total}, {"byStatus", statuses}};
+        }
+    };
+    
+    struct StationNode {
+        string name;
+        Counts counts;
+        set<string, IdOrder> ids;
+    };
+    
+    struct DistrictNode {
+        string name;
+        Counts counts;
+        unordered_map<string, StationNode> stations; // station name -> node
+    };
+    
+private:
+    unordered_map<string, DistrictNode> districts;
+    
+public:
+    void add(const FIRRecord& fir) {
+        DistrictNode& district = districts[fir.district];
+        district.name = fir.district;
+        StationNode& station = district.stations[fir.policeStation];
+        station.name = fir.policeStation;
+        if (!station.ids.insert(fir.id).second) return;
+        district.counts.add(fir.status, 1);
+        station.counts.add(fir.status, 1);
+    }
+    
+    void remove(const FIRRecord& fir) {
+        auto d = districts.find(fir.district);
+        if (d == districts.end()) return;
+        auto s = d->second.stations.find(fir.policeStation);
+        if (s == d->second.stations.end() || !s->second.ids.erase(fir.id)) return;
+        d->second.counts.add(fir.status, -1);
+        s->second.counts.add(fir.status, -1);
+        if (s->second.ids.empty()) d->second.stations.erase(s);
+        if (d->second.stations.empty()) districts.erase(d);
+    }
+    
+    const DistrictNode* district(const string& name) const {
+        auto it = districts.find(name);
+        return it != districts.end() ? &it->second : nullptr;
+    }
+    
+    const StationNode* station(const string& districtName, const string& stationName) const {
+        const DistrictNode* node = district(districtName);
+        if (!node) return nullptr;
+        auto it = node->stations.find(stationName);
+        return it != node->stations.end() ? &it->second : nullptr;
+    }
+    
+    const unordered_map<string, DistrictNode>& all() const {
+        return districts;
+    }
+};
+
 /**
  * FIR Management System
  */
 class FIRSystem {
 private:
-    AVLTree firTree;
+    FIRTable firTable; // owns each record once; O(1) by id, id-ordered walk
     Trie nameAutocomplete;
-    unordered_map<string, FIRRecord> firMap; // For O(1) lookup
+    ContactIndex byPhone; // normalized complainantPhone -> FIR ids
+    ContactIndex byEmail; // normalized complainantEmail -> FIR ids
+    JurisdictionIndex jurisdictions;
+    RateCounter stationRates; // FIRs created per station, keyed by stationKey()
+    unordered_map<string, uint32_t> stationKeys; // "district\x1fstation" -> rate key
+    vector<pair<string, string>> stationNames; // rate key -> district, station
+    MinHashIndex descriptionDuplicates; // LSH over incidentDescription
+    IPCSuggester ipcSuggester; // Aho-Corasick over all IPC keywords
+    IPCClassifier ipcClassifier; // Naive Bayes trained on labelled FIRs
     int firCounter;
+    string dataDir; // holds fir_store.db, fir_cold.pages and fir_data.snap
+    LSMStore durable; // fir_store.db: every FIR, written ahead of each change
+    string coldBefore; // closed FIRs registered before this are paged out
+    chrono::system_clock::time_point lastColdSweep;
+    mutable shared_mutex mutex; // readers share, every mutation is exclusive
+    
+    // Background export to fir_data.snap, see startSnapshot()
+    struct SnapshotStatus {
+        bool running = false;
+        size_t count = 0;
+        uint64_t bytes = 0;
+        double seconds = 0;
+        string finishedAt;
+        string error;
+    };
+    SnapshotStatus snapshotStatus; // guarded by snapshotMutex
+    std::mutex snapshotMutex;
+    thread snapshotThread;
+    atomic<bool> cancelSnapshot{false};
+    atomic<size_t> snapshotBytesPerSecond{kDefaultSnapshotBytesPerSecond};
+    
+    string dataPath(const string& name) const {
+        return dataDir + "/" + name;
+    }
     
     string generateFIRId() {
         return "FIR-" + to_string(++firCounter);
     }
     
-    string getCurrentTimestamp() {
-        auto now = chrono::system_clock::now();
-        auto time = chrono::system_clock::to_time_t(now);
+    static string formatTimestamp(chrono::system_clock::time_point when) {
+        auto time = chrono::system_clock::to_time_t(when);
+        tm local{};
+        localtime_r(&time, &local); // the snapshot thread formats too
         stringstream ss;
-        ss << put_time(localtime(&time), "%Y-%m-%d %H:%M:%S");
+        ss << put_time(&local, "%Y-%m-%d %H:%M:%S");
         return ss.str();
     }
     
+    string getCurrentTimestamp() {
+        return formatTimestamp(chrono::system_clock::now());
+    }
+    
+    // Closed and registered over a year ago; timestamps compare as text
+    bool isColdFIR(const FIRRecord& fir) const {
+        return fir.status.view() == "closed" && !fir.timestamp.empty() && fir.timestamp < coldBefore;
+    }
+    
+    // Advance the one-year cutoff and page out FIRs that crossed it.
+    // Runs at most once a day, from the write path.
+    void sweepColdFIRs() {
+        auto now = chrono::system_clock::now();
+        if (now - lastColdSweep < chrono::hours(24)) return;
+        lastColdSweep = now;
+        coldBefore = formatTimestamp(now - chrono::hours(24 * 365));
+        firTable.demoteCold();
+    }
+    
+    // One dense rate key per (district, station) pair. Capped at the
+    // counter's key capacity; stations past it share its overflow key.
+    uint32_t stationKey(const string& district, const string& station) {
+        string name = district + '\x1f' + station;
+        auto it = stationKeys.find(name);
+        if (it != stationKeys.end()) return it->second;
+        if (stationNames.size() >= RateCounter::kOverflowKey) return RateCounter::kOverflowKey;
+        uint32_t key = static_cast<uint32_t>(stationNames.size());
+        stationKeys.emplace(move(name), key);
+        stationNames.emplace_back(district, station);
+        return key;
+    }
+    
+    void indexContacts(const FIRRecord& fir) {
+        byPhone.add(ContactIndex::normalizePhone(fir.complainantPhone), fir.id);
+        byEmail.add(ContactIndex::normalizeEmail(fir.complainantEmail), fir.id);
+    }
+    
+    void unindexContacts(const FIRRecord& fir) {
+        byPhone.remove(ContactIndex::normalizePhone(fir.complainantPhone), fir.id);
+        byEmail.remove(ContactIndex::normalizeEmail(fir.complainantEmail), fir.id);
+    }
+    
+    // Secondary structures over stored FIRs. Inserts and deletes index or
+    // unindex every structure; edits go through reindexFIR(). The
+    // classifier and rate counters learn from events, not records, and
+    // are left as they are.
+    vector<MinHashIndex::Match> indexFIR(const FIRRecord& fir) {
+        nameAutocomplete.insert(fir.complainantName);
+        indexContacts(fir);
+        jurisdictions.add(fir);
+        return descriptionDuplicates.add(fir.id, fir.incidentDescription);
+    }
+    
+    void unindexFIR(const FIRRecord& fir) {
+        nameAutocomplete.remove(fir.complainantName);
+        unindexContacts(fir);
+        jurisdictions.remove(fir);
+        descriptionDuplicates.remove(fir.id);
+    }
+    
+    // Edit of a stored FIR: compare the old and new version field by
+    // field and touch only the structures whose inputs changed, so a
+    // status-only PUT moves the jurisdiction counts and nothing else.
+    // Returns the new version's near-duplicates either way.
+    vector<MinHashIndex::Match> reindexFIR(const FIRRecord& before, const FIRRecord& after) {
+        if (before.complainantName != after.complainantName) {
+            nameAutocomplete.remove(before.complainantName);
+            nameAutocomplete.insert(after.complainantName);
+        }
+        if (before.complainantPhone != after.complainantPhone || before.complainantEmail != after.complainantEmail) {
+            unindexContacts(before);
+            indexContacts(after);
+        }
+        if (before.district != after.district || before.policeStation != after.policeStation ||
+            before.status != after.status) {
+            jurisdictions.remove(before);
+            jurisdictions.add(after);
+        }
+        if (before.incidentDescription != after.incidentDescription) {
+            return descriptionDuplicates.add(after.id, after.incidentDescription);
+        }
+        return descriptionDuplicates.duplicatesOf(after.id);
+    }
+    
+    // Write a FIR (or its deletion) to the LSM store. Callers do this
+    // before touching memory, so a failed write changes nothing.
+    bool persist(const FIRRecord& fir, string& error) {
+        vector<uint8_t> bytes = json::to_msgpack(fir.toJSON());
+        return durable.put(fir.id, string(bytes.begin(), bytes.end()), error);
+    }
+    
+    bool unpersist(const string& id, string& error) {
+        return durable.remove(id, error);
+    }
+    
+    // Index a FIR read back from disk and learn from it
+    void restoreFIR(FIRRecord loaded) {
+        if (FIRTable::Ref previous = firTable.get(loaded.id)) {
+            unindexFIR(*previous);
+        }
+        FIRTable::Ref stored = firTable.put(move(loaded));
+        const FIRRecord& fir = *stored;
+        indexFIR(fir);
+        if (fir.ipcSectionsSource == "officer") {
+            ipcClassifier.train(fir.incidentDescription, fir.ipcSectionList());
+        }
+        
+        // Update counter
+        if (fir.id.substr(0, 4) == "FIR-") {
+            int num = stoi(fir.id.substr(4));
+            firCounter = max(firCounter, num);
+        }
+    }
+    
+    // Mutation pipeline for stored FIRs: change a copy, validate it,
+    // persist it, then write it over the stored record and reindex what
+    // changed. A rejected change leaves everything untouched.
+    json applyChange(const string& id, const function<void(FIRRecord&)>& change) {
+        FIRTable::Ref stored = firTable.get(id);
+        if (!stored) {
+            return {{"success", false}, {"error", "FIR not found"}};
+        }
+        FIRRecord next = *stored;
+        change(next);
+        next.id = id;
+        next.timestamp = stored->timestamp;
+        string error = validationError(next);
+        if (!error.empty() || !persist(next, error)) {
+            return {{"success", false}, {"error", error}};
+        }
+        
+        // Indexes copy what they keep, so diff against next before it is
+        // moved over the stored record
+        json duplicates = matchesToJSON(reindexFIR(*stored, next));
+        FIRTable::Ref updated = firTable.put(move(next));
+        return {
+            {"success", true},
+            {"firId", id},
+            {"data", updated->toJSON()},
+            {"possibleDuplicates", duplicates}
+        };
+    }
+    
+    static json matchesToJSON(const vector<MinHashIndex::Match>& matches) {
+        json result = json::array();
+        for (const auto& match : matches) {
+            result.push_back({{"firId", match.id}, {"similarity", match.similarity}});
+        }
+        return result;
+    }
+    
+    json recordsFor(const vector<string>& ids) {
+        json results = json::array();
+        for (const auto& id : ids) {
+            if (FIRTable::Ref fir = firTable.get(id)) results.push_back(fir->toJSON());
+        }
+        return {
+            {"success", true},
+            {"data", results},
+            {"count", results.size()}
+        };
+    }
+    
     bool validatePhone(const string& phone) {
         regex phoneRegex(R"(^\d{10}$)");
         return regex_match(phone, phoneRegex);
@@ -328,18 +959,152 @@ private:
         return regex_match(email, emailRegex);
     }
     
+    // Empty when the record may be stored
+    string validationError(const FIRRecord& fir) {
+        if (!validatePhone(fir.complainantPhone)) {
+            return "Invalid phone number. Must be 10 digits.";
+        }
+        if (!validateEmail(fir.complainantEmail)) {
+            return "Invalid email address.";
+        }
+        return "";
+    }
+    
+    static bool isKnownStatus(const string& status) {
+        return status == "pending" || status == "under_investigation" || status == "closed";
+    }
+    
+    // Checks a create, PUT or PATCH body before any of it is parsed into a
+    // record. Parsing interns status, ipcSectionsSource and ipcSections,
+    // and interned text is never freed, so only the fixed status and
+    // source values and section numbers the compiled catalog knows get
+    // through (ipc_catalog::findSection, one hash and one compare each).
+    // District and station are open vocabularies and stay plain text.
+    // Empty when the body may be applied.
+    static string requestError(const json& data) {
+        if (data.contains("status") && !(data["status"].is_string() && isKnownStatus(data["status"].get<string>()))) {
+            return "Invalid status. Must be pending, under_investigation or closed.";
+        }
+        if (data.contains("ipcSectionsSource")) {
+            const json& source = data["ipcSectionsSource"];
+            if (!source.is_string() || (source != "officer" && source != "suggested")) {
+                return "Invalid ipcSectionsSource. Must be officer or suggested.";
+            }
+        }
+        if (data.contains("ipcSections") && data["ipcSections"].is_array()) {
+            for (const auto& section : data["ipcSections"]) {
+                if (!section.is_string() || !ipc_catalog::findSection(section.get_ref<const string&>())) {
+                    return "Unknown IPC section " + section.dump();
+                }
+            }
+        }
+        return "";
+    }
+    
+    // Dictionary seed for snapshot files: the field names of an empty FIR
+    static string snapshotSeed() {
+        vector<uint8_t> bytes = json::to_msgpack(FIRRecord().toJSON());
+        return string(bytes.begin(), bytes.end());
+    }
+    
+    // Write a snapshot out as a record file (the stored MessagePack bodies,
+    // compressed in blocks against a shared dictionary), then rename it
+    // over fir_data.snap. Runs on snapshotThread under SCHED_IDLE, so it
+    // only gets CPU nobody else wants. Output is synced every chunk, and
+    // the thread sleeps between chunks to hold snapshotBytesPerSecond, so
+    // the log syncs of the write path never queue behind a burst of
+    // writeback.
+    void writeSnapshot(const LSMStore::Snapshot& view) {
+#if defined(__linux__)
+        sched_param idle{};
+        pthread_setschedparam(pthread_self(), SCHED_IDLE, &idle);
+#endif
+        auto start = chrono::steady_clock::now();
+        string path = dataPath("fir_data.snap");
+        string temp = path + ".tmp";
+        SnapshotStatus result;
+        try {
+            RecordFile::Writer file;
+            string error;
+            if (!file.open(temp, snapshotSeed(), RecordFile::Options(), error)) throw runtime_error(error);
+            uint64_t synced = 0;
+            auto drain = [&] {
+                if (!file.sync(error)) throw runtime_error(error);
+                synced = result.bytes = file.size();
+                {
+                    lock_guard<std::mutex> guard(snapshotMutex);
+                    snapshotStatus.count = result.count;
+                    snapshotStatus.bytes = result.bytes;
+                }
+                if (size_t rate = snapshotBytesPerSecond.load()) {
+                    this_thread::sleep_until(start + chrono::duration<double>(double(result.bytes) / rate));
+                }
+            };
+            string scanError;
+            bool scanned = durable.forEach(view, [&](const string&, const string& bytes) {
+                if (cancelSnapshot) throw runtime_error("cancelled");
+                if (!file.add(bytes, error)) throw runtime_error(error);
+                ++result.count;
+                if (file.size() - synced >= kSnapshotChunkBytes) drain();
+            }, scanError);
+            if (!scanned) throw runtime_error(scanError); // keep the last good snapshot
+            if (!file.finish(error)) throw runtime_error(error);
+            result.bytes = file.size();
+            if (rename(temp.c_str(), path.c_str()) != 0) throw runtime_error("cannot replace " + path);
+        } catch (const exception& e) {
+            remove(temp.c_str());
+            result.error = e.what();
+        }
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        result.finishedAt = getCurrentTimestamp();
+        if (result.error.empty()) {
+            cout << "✅ Snapshot of " << result.count << " FIRs saved to " << path << endl;
+        } else {
+            cerr << "❌ Snapshot failed: " << result.error << endl;
+        }
+        lock_guard<std::mutex> guard(snapshotMutex);
+        snapshotStatus = result;
+    }
+    
 public:
-    FIRSystem() : firCounter(0) {
-        loadFromFile();
+    static constexpr size_t kDefaultColdCacheBytes = 64 << 20;
+    static constexpr size_t kDefaultSnapshotBytesPerSecond = 32 << 20;
+    static constexpr size_t kSnapshotChunkBytes = 256 << 10;
+    
+    // coldCacheBytes bounds the page cache for cold FIR bodies; every
+    // file lives in directory
+    explicit FIRSystem(size_t coldCacheBytes = kDefaultColdCacheBytes, const string& directory = ".")
+        : ipcSuggester(ipc_catalog::kSections, ipc_catalog::kSectionCount), firCounter(0), dataDir(directory) {
+        string error;
+        error_code ec;
+        filesystem::create_directories(dataDir, ec);
+        if (!firTable.enableTiering(dataPath("fir_cold.pages"), coldCacheBytes,
+                                    [this](const FIRRecord& fir) { return isColdFIR(fir); }, error)) {
+            cerr << "⚠️  " << error << "; keeping every FIR in memory" << endl;
+        }
+        sweepColdFIRs();
+        loadFromStore();
     }
     
+    // A running snapshot is abandoned; fir_data.snap keeps the last one
     ~FIRSystem() {
-        saveToFile();
+        cancelSnapshot = true;
+        if (snapshotThread.joinable()) snapshotThread.join();
+    }
+    
+    // 0 lifts the limit
+    void setSnapshotRate(size_t bytesPerSecond) {
+        snapshotBytesPerSecond = bytesPerSecond;
     }
     
     // Create new FIR
     json createFIR(const json& data) {
+        unique_lock<shared_mutex> lock(mutex);
+        sweepColdFIRs();
         try {
+            if (string error = requestError(data); !error.empty()) {
+                return {{"success", false}, {"error", error}};
+            }
             FIRRecord fir;
             fir.id = generateFIRId();
             fir.district = data.value("district", "");
@@ -360,31 +1125,69 @@ public:
             fir.propertyDescription = data.value("propertyDescription", "");
             
             if (data.contains("ipcSections") && data["ipcSections"].is_array()) {
-                fir.ipcSections = data["ipcSections"].get<vector<string>>();
+                fir.ipcSections = data["ipcSections"].get<vector<InternedString>>();
+            }
+            fir.ipcSectionsSource = "officer";
+            
+            // Suggest sections from the description (single linear scan)
+            vector<SectionMatch> suggestions = ipcSuggester.suggest(fir.incidentDescription, 5);
+            json suggested = json::array();
+            for (const auto& match : suggestions) {
+                suggested.push_back({
+                    {"section", string(match.section->section)},
+                    {"title", string(match.section->title)},
+                    {"score", match.score}
+                });
+            }
+            
+            // Learned model catches wording the keyword list misses
+            json predicted = json::array();
+            for (const auto& [section, probability] : ipcClassifier.predict(fir.incidentDescription, 3)) {
+                predicted.push_back({{"section", section}, {"probability", probability}});
+            }
+            
+            if (fir.ipcSections.empty()) {
+                for (size_t i = 0; i < suggestions.size() && i < 3; ++i) {
+                    fir.ipcSections.push_back(string(suggestions[i].section->section));
+                }
+                if (fir.ipcSections.empty() && !predicted.empty()) {
+                    fir.ipcSections.push_back(predicted[0]["section"].get<string>());
+                }
+                if (!fir.ipcSections.empty()) {
+                    fir.ipcSectionsSource = "suggested";
+                }
             }
             
             fir.timestamp = getCurrentTimestamp();
             fir.status = "pending";
             
             // Validate
-            if (!validatePhone(fir.complainantPhone)) {
-                return {{"success", false}, {"error", "Invalid phone number. Must be 10 digits."}};
-            }
-            
-            if (!validateEmail(fir.complainantEmail)) {
-                return {{"success", false}, {"error", "Invalid email address."}};
+            string error = validationError(fir);
+            if (!error.empty() || !persist(fir, error)) {
+                return {{"success", false}, {"error", error}};
             }
             
             // Store in data structures
-            firTree.insert(fir);
-            firMap[fir.id] = fir;
-            nameAutocomplete.insert(fir.complainantName);
+            FIRTable::Ref stored = firTable.put(move(fir));
+            json duplicates = matchesToJSON(indexFIR(*stored));
+            uint32_t rateKey = stationKey(stored->district, stored->policeStation);
+            if (stored->ipcSectionsSource == "officer") {
+                ipcClassifier.train(stored->incidentDescription, stored->ipcSectionList());
+            }
             
-            return {
+            json response = {
                 {"success", true},
-                {"firId", fir.id},
-                {"data", fir.toJSON()}
+                {"firId", stored->id},
+                {"data", stored->toJSON()},
+                {"suggestedSections", suggested},
+                {"predictedSections", predicted},
+                {"possibleDuplicates", duplicates}
             };
+            // The counter is lock-free, so count the FIR once the write
+            // lock is released
+            lock.unlock();
+            stationRates.record(rateKey);
+            return response;
             
         } catch (const exception& e) {
             return {{"success", false}, {"error", e.what()}};
@@ -393,27 +1196,30 @@ public:
     
     // Get FIR by ID - O(1) using hash map
     json getFIR(const string& id) {
+        shared_lock<shared_mutex> lock(mutex);
         string upperId = id;
         transform(upperId.begin(), upperId.end(), upperId.begin(), ::toupper);
         
-        auto it = firMap.find(upperId);
-        if (it != firMap.end()) {
+        if (FIRTable::Ref fir = firTable.get(upperId)) {
             return {
                 {"success", true},
-                {"data", it->second.toJSON()}
+                {"data", fir->toJSON()}
             };
         }
         
         // Try case-insensitive search
-        for (auto& [key, value] : firMap) {
+        const string* match = nullptr;
+        firTable.forEachId([&](const string& key) {
+            if (match) return;
             string upperKey = key;
             transform(upperKey.begin(), upperKey.end(), upperKey.begin(), ::toupper);
-            if (upperKey == upperId) {
-                return {
-                    {"success", true},
-                    {"data", value.toJSON()}
-                };
-            }
+            if (upperKey == upperId) match = &key;
+        });
+        if (match) {
+            return {
+                {"success", true},
+                {"data", firTable.get(*match)->toJSON()}
+            };
         }
         
         return {{"success", false}, {"error", "FIR not found"}};
@@ -421,37 +1227,33 @@ public:
     
     // Get all FIRs
     json getAllFIRs() {
-        vector<FIRRecord> allFIRs = firTree.getAllRecords();
+        shared_lock<shared_mutex> lock(mutex);
         json result = json::array();
         
-        for (const auto& fir : allFIRs) {
+        firTable.forEachOrdered([&](const FIRRecord& fir) {
             result.push_back(fir.toJSON());
-        }
+        });
         
         return {
             {"success", true},
             {"data", result},
-            {"count", allFIRs.size()}
+            {"count", result.size()}
         };
     }
     
     // Search FIRs by keyword
     json searchFIRs(const string& keyword) {
-        vector<FIRRecord> allFIRs = firTree.getAllRecords();
+        shared_lock<shared_mutex> lock(mutex);
         json results = json::array();
         
-        string lowerKeyword = keyword;
-        transform(lowerKeyword.begin(), lowerKeyword.end(), lowerKeyword.begin(), ::tolower);
+        CaseInsensitiveMatcher matcher(keyword);
         
-        for (const auto& fir : allFIRs) {
-            string searchText = fir.id + " " + fir.complainantName + " " + 
-                               fir.incidentDescription + " " + fir.suspectName;
-            transform(searchText.begin(), searchText.end(), searchText.begin(), ::tolower);
-            
-            if (searchText.find(lowerKeyword) != string::npos) {
+        firTable.forEachOrdered([&](const FIRRecord& fir) {
+            if (matcher.matches(fir.id) || matcher.matches(fir.complainantName) ||
+                matcher.matches(fir.incidentDescription) || matcher.matches(fir.suspectName)) {
                 results.push_back(fir.toJSON());
             }
-        }
+        });
         
         return {
             {"success", true},
@@ -460,8 +1262,23 @@ public:
         };
     }
     
+    // Predict IPC sections for free text with the trained classifier
+    json classifyDescription(const string& description, size_t k) {
+        shared_lock<shared_mutex> lock(mutex);
+        json sections = json::array();
+        for (const auto& [section, probability] : ipcClassifier.predict(description, k)) {
+            sections.push_back({{"section", section}, {"probability", probability}});
+        }
+        return {
+            {"success", true},
+            {"sections", sections},
+            {"trainedOn", ipcClassifier.documentCount()}
+        };
+    }
+    
     // Autocomplete for names
     json getAutocomplete(const string& prefix) {
+        shared_lock<shared_mutex> lock(mutex);
         vector<string> suggestions = nameAutocomplete.autocomplete(prefix);
         return {
             {"success", true},
@@ -469,38 +1286,282 @@ public:
         };
     }
     
+    // All FIRs filed from a phone number - O(1) hash lookup
+    json findByPhone(const string& phone) {
+        shared_lock<shared_mutex> lock(mutex);
+        return recordsFor(byPhone.find(ContactIndex::normalizePhone(phone)));
+    }
+    
+    // All FIRs filed from an email address - O(1) hash lookup
+    json findByEmail(const string& email) {
+        shared_lock<shared_mutex> lock(mutex);
+        return recordsFor(byEmail.find(ContactIndex::normalizeEmail(email)));
+    }
+    
+    // Status counts for every district - O(districts)
+    json listDistricts() {
+        shared_lock<shared_mutex> lock(mutex);
+        json result = json::array();
+        for (const auto& [name, node] : jurisdictions.all()) {
+            json entry = node.counts.toJSON();
+            entry["district"] = node.name;
+            entry["stations"] = node.stations.size();
+            result.push_back(entry);
+        }
+        return {{"success", true}, {"data", result}};
+    }
+    
+    // District rollup with per-station counts - O(1) for the district totals
+    json districtSummary(const string& district) {
+        shared_lock<shared_mutex> lock(mutex);
+        const JurisdictionIndex::DistrictNode* node = jurisdictions.district(district);
+        if (!node) {
+            return {{"success", false}, {"error", "District not found"}};
+        }
+        json stations = json::array();
+        for (const auto& [name, station] : node->stations) {
+            json entry = station.counts.toJSON();
+            entry["policeStation"] = station.name;
+            stations.push_back(entry);
+        }
+        json result = node->counts.toJSON();
+        result["district"] = node->name;
+        result["stations"] = stations;
+        return {{"success", true}, {"data", result}};
+    }
+    
+    // FIRs registered at one station, in id order - O(k)
+    json stationFIRs(const string& district, const string& station) {
+        shared_lock<shared_mutex> lock(mutex);
+        const JurisdictionIndex::StationNode* node = jurisdictions.station(district, station);
+        if (!node) {
+            return {{"success", false}, {"error", "Police station not found"}};
+        }
+        json result = recordsFor(vector<string>(node->ids.begin(), node->ids.end()));
+        result["counts"] = node->counts.toJSON();
+        return result;
+    }
+    
+    // Earlier FIRs whose description nearly matches this one
+    json findDuplicates(const string& id) {
+        shared_lock<shared_mutex> lock(mutex);
+        if (!firTable.contains(id)) {
+            return {{"success", false}, {"error", "FIR not found"}};
+        }
+        return {
+            {"success", true},
+            {"firId", id},
+            {"duplicates", matchesToJSON(descriptionDuplicates.duplicatesOf(id))}
+        };
+    }
+    
+    // FIRs created in the last minute / hour / day, per station. Stations
+    // past the counter's key capacity are summed under otherStations.
+    json stationRateSummary(const string& district, const string& station) {
+        shared_lock<shared_mutex> lock(mutex); // guards stationNames
+        json result = json::array();
+        for (uint32_t key : stationRates.keysSeen()) {
+            if (key >= stationNames.size()) continue;
+            const auto& [keyDistrict, keyStation] = stationNames[key];
+            if ((!district.empty() && keyDistrict != district) || (!station.empty() && keyStation != station)) {
+                continue;
+            }
+            RateCounter::Rates rates = stationRates.rates(key);
+            result.push_back({
+                {"district", keyDistrict},
+                {"policeStation", keyStation},
+                {"lastMinute", rates.lastMinute},
+                {"lastHour", rates.lastHour},
+                {"lastDay", rates.lastDay}
+            });
+        }
+        RateCounter::Rates other = stationRates.rates(RateCounter::kOverflowKey);
+        return {
+            {"success", true},
+            {"data", result},
+            {"otherStations", {
+                {"lastMinute", other.lastMinute},
+                {"lastHour", other.lastHour},
+                {"lastDay", other.lastDay}
+            }}
+        };
+    }
+    
+    // Hot/cold split, page cache counters and LSM store shape
+    json storageStats() {
+        shared_lock<shared_mutex> lock(mutex);
+        FIRTable::Stats stats = firTable.stats();
+        LSMStore::Stats lsm = durable.stats();
+        json levels = json::array();
+        for (size_t level = 0; level < lsm.tablesPerLevel.size(); ++level) {
+            levels.push_back({{"tables", lsm.tablesPerLevel[level]}, {"bytes", lsm.bytesPerLevel[level]}});
+        }
+        return {
+            {"success", true},
+            {"data", {
+                {"hotFIRs", stats.hot},
+                {"coldFIRs", stats.cold},
+                {"coldBefore", coldBefore},
+                {"cacheHits", stats.pages.hits},
+                {"cacheMisses", stats.pages.misses},
+                {"cachedBytes", stats.pages.cachedBytes},
+                {"pageFileBytes", stats.pages.fileBytes},
+                {"garbageBytes", stats.pages.garbageBytes},
+                {"store", {
+                    {"levels", levels},
+                    {"memtableBytes", lsm.memtableBytes},
+                    {"flushes", lsm.flushes},
+                    {"compactions", lsm.compactions},
+                    {"blockReads", lsm.blockReads}
+                }}
+            }}
+        };
+    }
+    
     // Update FIR status
     json updateStatus(const string& id, const string& status) {
-        auto it = firMap.find(id);
-        if (it != firMap.end()) {
-            it->second.status = status;
-            return {{"success", true}, {"message", "Status updated"}};
+        if (string error = requestError({{"status", status}}); !error.empty()) {
+            return {{"success", false}, {"error", error}};
         }
-        return {{"success", false}, {"error", "FIR not found"}};
+        unique_lock<shared_mutex> lock(mutex);
+        json result = applyChange(id, [&status](FIRRecord& fir) { fir.status = status; });
+        if (result["success"]) result["message"] = "Status updated";
+        return result;
+    }
+    
+    // Replace every editable field (fields missing from data reset to defaults)
+    json updateFIR(const string& id, const json& data) {
+        if (string error = requestError(data); !error.empty()) {
+            return {{"success", false}, {"error", error}};
+        }
+        unique_lock<shared_mutex> lock(mutex);
+        return applyChange(id, [&data](FIRRecord& fir) { fir = FIRRecord::fromJSON(data); });
+    }
+    
+    // Change only the fields present in data
+    json patchFIR(const string& id, const json& data) {
+        if (string error = requestError(data); !error.empty()) {
+            return {{"success", false}, {"error", error}};
+        }
+        unique_lock<shared_mutex> lock(mutex);
+        return applyChange(id, [&data](FIRRecord& fir) { fir.applyJSON(data); });
+    }
+    
+    json deleteFIR(const string& id) {
+        unique_lock<shared_mutex> lock(mutex);
+        FIRTable::Ref fir = firTable.get(id);
+        if (!fir) {
+            return {{"success", false}, {"error", "FIR not found"}};
+        }
+        string error;
+        if (!unpersist(id, error)) {
+            return {{"success", false}, {"error", error}};
+        }
+        unindexFIR(*fir);
+        firTable.erase(id);
+        return {{"success", true}, {"firId", id}, {"message", "FIR deleted"}};
     }
     
-    // Save to file
-    void saveToFile() {
+    // Export every FIR, as of now, to fir_data.snap. The LSM store is the
+    // durable copy; this is a portable snapshot on request. The view is
+    // pinned from the store without taking the FIR lock (each change is
+    // persisted before memory is touched, so the store is never behind
+    // what readers can see) and written out in the background, so writers
+    // are held up only for the memtable freeze.
+    json startSnapshot() {
+        lock_guard<std::mutex> guard(snapshotMutex);
+        if (snapshotStatus.running) {
+            return {{"success", false}, {"error", "A snapshot is already running"}};
+        }
+        LSMStore::Snapshot view;
+        string error;
+        if (!durable.snapshot(view, error)) {
+            return {{"success", false}, {"error", error}};
+        }
+        if (snapshotThread.joinable()) snapshotThread.join();
+        snapshotStatus = SnapshotStatus();
+        snapshotStatus.running = true;
+        snapshotThread = thread([this, view = move(view)] { writeSnapshot(view); });
+        return {{"success", true}, {"message", "Snapshot started"}, {"path", dataPath("fir_data.snap")}};
+    }
+    
+    // Progress of the running snapshot, or the outcome of the last one
+    json snapshotInfo() {
+        lock_guard<std::mutex> guard(snapshotMutex);
+        const SnapshotStatus& status = snapshotStatus;
+        return {
+            {"success", true},
+            {"data", {
+                {"running", status.running},
+                {"count", status.count},
+                {"bytes", status.bytes},
+                {"seconds", status.seconds},
+                {"finishedAt", status.finishedAt},
+                {"error", status.error}
+            }}
+        };
+    }
+    
+    // Open fir_store.db and index every FIR in it. A store opened for the
+    // first time is seeded from a snapshot: fir_data.snap, or fir_data.json
+    // as exported before snapshots were compressed. An existing store that
+    // is empty is left empty; its FIRs were deleted.
+    void loadFromStore() {
+        LSMStore::Options options;
+        options.syncWrites = true;
+        string error;
+        if (!durable.open(dataPath("fir_store.db"), error, options)) {
+            cerr << "❌ Error opening FIR store: " << error << endl;
+            return;
+        }
+        size_t count = 0;
         try {
-            ofstream file("fir_data.json");
-            json allData = json::array();
-            
-            for (const auto& [id, fir] : firMap) {
-                allData.push_back(fir.toJSON());
+            if (!durable.forEach([&](const string&, const string& bytes) {
+                    restoreFIR(FIRRecord::fromJSON(json::from_msgpack(bytes)));
+                    ++count;
+                }, error)) {
+                cerr << "❌ Error loading data: " << error << endl;
             }
-            
-            file << allData.dump(4);
-            file.close();
-            cout << "✅ Data saved to fir_data.json" << endl;
         } catch (const exception& e) {
-            cerr << "❌ Error saving data: " << e.what() << endl;
+            cerr << "❌ Error loading data: " << e.what() << endl;
         }
+        if (!durable.created()) {
+            cout << "✅ Loaded " << count << " FIR records from fir_store.db" << endl;
+            return;
+        }
+        loadFromFile();
     }
     
-    // Load from file
+    // Import one FIR from a snapshot into the store and memory
+    void importFIR(FIRRecord loaded) {
+        string error;
+        if (!persist(loaded, error)) {
+            cerr << "❌ Error importing " << loaded.id << ": " << error << endl;
+        }
+        restoreFIR(move(loaded));
+    }
+    
+    // Load from file, copying each FIR into the store
     void loadFromFile() {
+        string snapshot = dataPath("fir_data.snap");
+        if (RecordFile::matches(snapshot)) {
+            size_t count = 0;
+            string error;
+            try {
+                if (!RecordFile::read(snapshot, [&](const string& bytes) {
+                        importFIR(FIRRecord::fromJSON(json::from_msgpack(bytes)));
+                        ++count;
+                    }, error)) {
+                    cerr << "❌ Error loading data: " << error << endl;
+                }
+            } catch (const exception& e) {
+                cerr << "❌ Error loading data: " << e.what() << endl;
+            }
+            cout << "✅ Loaded " << count << " FIR records from " << snapshot << endl;
+            return;
+        }
         try {
-            ifstream file("fir_data.json");
+            ifstream file(dataPath("fir_data.json"));
             if (!file.is_open()) {
                 cout << "ℹ️  No existing data file found. Starting fresh." << endl;
                 return;
@@ -512,16 +1573,7 @@ public:
             
             if (allData.is_array()) {
                 for (const auto& item : allData) {
-                    FIRRecord fir = FIRRecord::fromJSON(item);
-                    firTree.insert(fir);
-                    firMap[fir.id] = fir;
-                    nameAutocomplete.insert(fir.complainantName);
-                    
-                    // Update counter
-                    if (fir.id.substr(0, 4) == "FIR-") {
-                        int num = stoi(fir.id.substr(4));
-                        firCounter = max(firCounter, num);
-                    }
+                    importFIR(FIRRecord::fromJSON(item));
                 }
                 cout << "✅ Loaded " << allData.size() << " FIR records" << endl;
             }
@@ -531,28 +1583,252 @@ public:
     }
 };
 
+// ========================================
+// Memory Benchmark
+// ========================================
+
+// Heap bytes in use, mmapped blocks included (glibc only; 0 elsewhere)
+static size_t heapInUse() {
+#if defined(__GLIBC__)
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Store synthetic FIRs and report heap per stored record. With
+ * coldPercent > 0 that share of them is closed and paged out, and random
+ * cold reads are timed against the page cache.
+ * Run: ./fir_server --memory-bench [records] [coldPercent] [cacheMB]
+ */
+int memoryBench(size_t count, size_t coldPercent, size_t cacheMB) {
+    static const char* districts[] = {"Pune", "Mumbai", "Nagpur", "Nashik", "Thane", "Solapur"};
+    static const char* stations[] = {"Central", "North", "South", "East", "West", "Cantonment"};
+    static const char* names[] = {"Ravi Kumar", "Asha Deshmukh", "Imran Shaikh", "Priya Nair", "Suresh Patil"};
+    mt19937 rng(7);
+    vector<string> vocabulary(2000);
+    for (auto& word : vocabulary) {
+        for (size_t c = 0, n = 4 + rng() % 5; c < n; ++c) word.push_back(char('a' + rng() % 26));
+    }
+    
+    size_t before = heapInUse();
+    auto start = chrono::steady_clock::now();
+    {
+        FIRTable firTable;
+        string error;
+        if (coldPercent && !firTable.enableTiering("fir_bench.pages", cacheMB << 20,
+                                                   [](const FIRRecord& fir) { return fir.status.view() == "closed"; },
+                                                   error)) {
+            cerr << error << endl;
+            return 1;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            FIRRecord fir;
+            fir.id = "FIR-" + to_string(i + 1);
+            fir.district = districts[i % 6];
+            fir.policeStation = stations[(i / 6) % 6];
+            fir.complainantName = string(names[i % 5]) + " " + to_string(i % 1000);
+            fir.complainantFatherName = names[(i + 1) % 5];
+            fir.complainantAddress = "House " + to_string(i % 500) + ", Shivaji Nagar";
+            fir.complainantPhone = to_string(9000000000ULL + i);
+            fir.complainantEmail = "user" + to_string(i) + "@example.com";
+            fir.dateOfIncident = "2025-0" + to_string(1 + i % 9) + "-1" + to_string(i % 10);
+            fir.timeOfIncident = "21:30";
+            fir.placeOfIncident = "Main Road";
+            for (int w = 0; w < 12; ++w) fir.incidentDescription += vocabulary[rng() % vocabulary.size()] + " ";
+            fir.suspectName = i % 3 ? "Unknown" : names[(i + 2) % 5];
+            fir.ipcSections = {InternedString("379")};
+            fir.ipcSectionsSource = "officer";
+            fir.timestamp = "2025-10-01 10:00:00";
+            fir.status = i % 100 < coldPercent ? "closed" : "pending";
+            firTable.put(move(fir));
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        size_t used = heapInUse() - before;
+        FIRTable::Stats stats = firTable.stats();
+        cout << "Records: " << count << " (" << stats.cold << " cold) in " << seconds << " s" << endl;
+        cout << "Heap: " << used / (1024.0 * 1024.0) << " MiB, " << used / count << " bytes/record" << endl;
+        if (!stats.cold) return 0;
+        
+        // Skewed cold reads: 90% go to 1% of the cold ids
+        cout << "Page file: " << stats.pages.fileBytes / (1024.0 * 1024.0) << " MiB" << endl;
+        const size_t reads = 200000;
+        size_t hotSet = max<size_t>(1, count / 100);
+        start = chrono::steady_clock::now();
+        for (size_t r = 0; r < reads; ++r) {
+            size_t i = rng() % 10 ? rng() % hotSet : rng() % count;
+            i = i / 100 * 100 + i % coldPercent; // land on a cold record
+            if (i >= count) i = i % coldPercent;
+            if (!firTable.get("FIR-" + to_string(i + 1))) {
+                cerr << "missing FIR-" << i + 1 << endl;
+                return 1;
+            }
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        PageFile::Stats pages = firTable.stats().pages;
+        cout << "Cold reads: " << reads << ", " << seconds * 1e6 / reads << " us/read, "
+             << pages.misses << " preads (" << 100.0 * pages.misses / reads << "%), cache "
+             << pages.cachedBytes / (1024.0 * 1024.0) << " MiB" << endl;
+    }
+    return 0;
+}
+
+// ========================================
+// Snapshot Benchmark
+// ========================================
+
+struct LatencySummary {
+    size_t count = 0;
+    double p50 = 0, p99 = 0, max = 0; // microseconds
+};
+
+static LatencySummary summarize(vector<double> micros) {
+    LatencySummary summary;
+    summary.count = micros.size();
+    if (micros.empty()) return summary;
+    sort(micros.begin(), micros.end());
+    summary.p50 = micros[micros.size() / 2];
+    summary.p99 = micros[micros.size() * 99 / 100];
+    summary.max = micros.back();
+    return summary;
+}
+
+/**
+ * Create latency with and without a snapshot in flight. Loads records
+ * FIRs into a scratch directory, then issues creates at a steady rate
+ * (open loop: latency counts from when a create was due, so stalls show
+ * in full), first on their own and then for as long as a throttled
+ * snapshot runs. Last, an unthrottled snapshot with no writers shows how
+ * long a dump under the FIR lock would have stalled them.
+ * Run: ./fir_server --snapshot-bench [records] [snapshotMBps] [createsPerSecond]
+ */
+int snapshotBench(size_t count, size_t mbps, size_t createsPerSecond) {
+    const string dir = "snapshot_bench.d";
+    error_code ec;
+    filesystem::remove_all(dir, ec);
+    static const char* districts[] = {"Pune", "Mumbai", "Nagpur", "Nashik", "Thane", "Solapur"};
+    mt19937 rng(11);
+    vector<string> vocabulary(2000);
+    for (auto& word : vocabulary) {
+        for (size_t c = 0, n = 4 + rng() % 5; c < n; ++c) word.push_back(char('a' + rng() % 26));
+    }
+    auto request = [&](size_t i) {
+        string description;
+        for (int w = 0; w < 30; ++w) description += vocabulary[rng() % vocabulary.size()] + " ";
+        return json{
+            {"district", districts[i % 6]},
+            {"policeStation", "Station " + to_string(i % 40)},
+            {"complainantName", "Complainant " + to_string(i)},
+            {"complainantPhone", to_string(9000000000ULL + i)},
+            {"complainantEmail", "user" + to_string(i) + "@example.com"},
+            {"dateOfIncident", "2025-06-15"},
+            {"placeOfIncident", "Main Road"},
+            {"incidentDescription", description},
+            {"ipcSections", {"379"}}
+        };
+    };
+    
+    int status = 0;
+    {
+        FIRSystem firSystem(FIRSystem::kDefaultColdCacheBytes, dir);
+        firSystem.setSnapshotRate(mbps << 20);
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) firSystem.createFIR(request(i));
+        cout << "Loaded " << count << " FIRs in "
+             << chrono::duration<double>(chrono::steady_clock::now() - start).count() << " s" << endl;
+        
+        size_t next = count;
+        auto interval = chrono::duration_cast<chrono::steady_clock::duration>(
+            chrono::duration<double>(1.0 / max<size_t>(createsPerSecond, 1)));
+        auto pacedCreates = [&](auto&& more) {
+            vector<double> micros;
+            auto due = chrono::steady_clock::now();
+            while (more(micros.size())) {
+                this_thread::sleep_until(due);
+                firSystem.createFIR(request(next++));
+                micros.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - due).count());
+                due += interval;
+            }
+            return summarize(micros);
+        };
+        auto running = [&] { return firSystem.snapshotInfo()["data"]["running"].get<bool>(); };
+        auto report = [](const string& label, const LatencySummary& s) {
+            cout << label << ": " << s.count << " creates, p50 " << s.p50 << " us, p99 " << s.p99
+                 << " us, max " << s.max << " us" << endl;
+        };
+        
+        cout << "Creates at " << createsPerSecond << "/s" << endl;
+        report("  no snapshot", pacedCreates([](size_t done) { return done < 4000; }));
+        
+        start = chrono::steady_clock::now();
+        json started = firSystem.startSnapshot();
+        double startMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+        if (!started["success"].get<bool>()) {
+            cerr << started.dump() << endl;
+            return 1;
+        }
+        report("  during snapshot", pacedCreates([&](size_t) { return running(); }));
+        json info = firSystem.snapshotInfo()["data"];
+        cout << "Snapshot at " << mbps << " MiB/s: started in " << startMicros << " us, " << info["count"]
+             << " FIRs, " << info["bytes"].get<uint64_t>() / (1024.0 * 1024.0) << " MiB in " << info["seconds"]
+             << " s" << endl;
+        status = info["error"].get<string>().empty() ? 0 : 1;
+        
+        firSystem.setSnapshotRate(0);
+        firSystem.startSnapshot();
+        while (running()) this_thread::sleep_for(chrono::milliseconds(10));
+        info = firSystem.snapshotInfo()["data"];
+        cout << "Unthrottled snapshot, no writers: " << info["count"] << " FIRs in " << info["seconds"]
+             << " s (the stall a dump under the FIR lock costs writers)" << endl;
+    }
+    filesystem::remove_all(dir, ec);
+    return status;
+}
+
 // ========================================
 // HTTP Server
 // ========================================
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && string(argv[1]) == "--memory-bench") {
+        return memoryBench(argc > 2 ? stoul(argv[2]) : 1000000, argc > 3 ? min<size_t>(stoul(argv[3]), 100) : 0,
+                           argc > 4 ? stoul(argv[4]) : FIRSystem::kDefaultColdCacheBytes >> 20);
+    }
+    if (argc > 1 && string(argv[1]) == "--snapshot-bench") {
+        return snapshotBench(argc > 2 ? stoul(argv[2]) : 50000,
+                             argc > 3 ? stoul(argv[3]) : FIRSystem::kDefaultSnapshotBytesPerSecond >> 20,
+                             argc > 4 ? stoul(argv[4]) : 200);
+    }
+    
     cout << "🚀 Starting FIR Management Server..." << endl;
     cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
     
-    FIRSystem firSystem;
+    // --cache-mb N: page cache budget for cold FIR bodies
+    // --snapshot-mbps N: snapshot write rate (0 = unthrottled)
+    size_t coldCacheBytes = FIRSystem::kDefaultColdCacheBytes;
+    size_t snapshotRate = FIRSystem::kDefaultSnapshotBytesPerSecond;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (string(argv[i]) == "--cache-mb") coldCacheBytes = stoul(argv[i + 1]) << 20;
+        if (string(argv[i]) == "--snapshot-mbps") snapshotRate = stoul(argv[i + 1]) << 20;
+    }
+    
+    FIRSystem firSystem(coldCacheBytes);
+    firSystem.setSnapshotRate(snapshotRate);
     Server server;
     
     // Enable CORS
     server.set_default_headers({
         {"Access-Control-Allow-Origin", "*"},
-        {"Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS"},
+        {"Access-Control-Allow-Methods", "GET, POST, PUT, PATCH, DELETE, OPTIONS"},
         {"Access-Control-Allow-Headers", "Content-Type"}
     });
     
     // Handle OPTIONS requests (CORS preflight)
     server.Options(".*", [](const Request& req, Response& res) {
         res.set_header("Access-Control-Allow-Origin", "*");
-        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
+        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, PATCH, DELETE, OPTIONS");
         res.set_header("Access-Control-Allow-Headers", "Content-Type");
         res.status = 200;
     });
@@ -580,6 +1856,12 @@ int main() {
         }
     });
     
+    // Get all FIRs (registered before /:id, which would otherwise match "all")
+    server.Get("/api/fir/all", [&firSystem](const Request& req, Response& res) {
+        json response = firSystem.getAllFIRs();
+        res.set_content(response.dump(), "application/json");
+    });
+    
     // Get FIR by ID
     server.Get("/api/fir/:id", [&firSystem](const Request& req, Response& res) {
         string id = req.path_params.at("id");
@@ -587,12 +1869,6 @@ int main() {
         res.set_content(response.dump(), "application/json");
     });
     
-    // Get all FIRs
-    server.Get("/api/fir/all", [&firSystem](const Request& req, Response& res) {
-        json response = firSystem.getAllFIRs();
-        res.set_content(response.dump(), "application/json");
-    });
-    
     // Search FIRs
     server.Get("/api/fir/search/:keyword", [&firSystem](const Request& req, Response& res) {
         string keyword = req.path_params.at("keyword");
@@ -600,6 +1876,73 @@ int main() {
         res.set_content(response.dump(), "application/json");
     });
     
+    // Near-duplicate FIRs by description
+    server.Get("/api/fir/:id/duplicates", [&firSystem](const Request& req, Response& res) {
+        json response = firSystem.findDuplicates(req.path_params.at("id"));
+        res.set_content(response.dump(), "application/json");
+    });
+    
+    // FIRs by complainant phone / email
+    server.Get("/api/fir/by-phone/:phone", [&firSystem](const Request& req, Response& res) {
+        json response = firSystem.findByPhone(req.path_params.at("phone"));
+        res.set_content(response.dump(), "application/json");
+    });
+    
+    server.Get("/api/fir/by-email/:email", [&firSystem](const Request& req, Response& res) {
+        json response = firSystem.findByEmail(req.path_params.at("email"));
+        res.set_content(response.dump(), "application/json");
+    });
+    
+    // District / police station rollups
+    server.Get("/api/districts", [&firSystem](const Request& req, Response& res) {
+        json response = firSystem.listDistricts();
+        res.set_content(response.dump(), "application/json");
+    });
+    
+    server.Get("/api/districts/:district", [&firSystem](const Request& req, Response& res) {
+        json response = firSystem.districtSummary(req.path_params.at("district"));
+        res.set_content(response.dump(), "application/json");
+    });
+    
+    server.Get("/api/districts/:district/stations/:station", [&firSystem](const Request& req, Response& res) {
+        json response = firSystem.stationFIRs(req.path_params.at("district"), req.path_params.at("station"));
+        res.set_content(response.dump(), "application/json");
+    });
+    
+    // FIR creation rates per station (optional ?district=&station= filters)
+    server.Get("/api/analytics/rate", [&firSystem](const Request& req, Response& res) {
+        json response = firSystem.stationRateSummary(req.get_param_value("district"), req.get_param_value("station"));
+        res.set_content(response.dump(), "application/json");
+    });
+    
+    // Hot/cold record counts, cold page cache and LSM levels
+    server.Get("/api/storage/stats", [&firSystem](const Request& req, Response& res) {
+        res.set_content(firSystem.storageStats().dump(), "application/json");
+    });
+    
+    // Export all FIRs to fir_data.snap in the background / its progress
+    server.Post("/api/admin/snapshot", [&firSystem](const Request& req, Response& res) {
+        res.set_content(firSystem.startSnapshot().dump(), "application/json");
+    });
+    
+    server.Get("/api/admin/snapshot", [&firSystem](const Request& req, Response& res) {
+        res.set_content(firSystem.snapshotInfo().dump(), "application/json");
+    });
+    
+    // Classify incident description into IPC sections
+    server.Post("/api/ipc/classify", [&firSystem](const Request& req, Response& res) {
+        try {
+            json requestData = json::parse(req.body);
+            string description = requestData.value("description", "");
+            size_t k = requestData.value("k", 3);
+            json response = firSystem.classifyDescription(description, min<size_t>(k, 20));
+            res.set_content(response.dump(), "application/json");
+        } catch (const exception& e) {
+            json error = {{"success", false}, {"error", e.what()}};
+            res.set_content(error.dump(), "application/json");
+        }
+    });
+    
     // Autocomplete
     server.Get("/api/autocomplete/:prefix", [&firSystem](const Request& req, Response& res) {
         string prefix = req.path_params.at("prefix");
@@ -621,6 +1964,34 @@ int main() {
         }
     });
     
+    // Replace / partially update / delete a FIR
+    server.Put("/api/fir/:id", [&firSystem](const Request& req, Response& res) {
+        try {
+            json requestData = json::parse(req.body);
+            json response = firSystem.updateFIR(req.path_params.at("id"), requestData);
+            res.set_content(response.dump(), "application/json");
+        } catch (const exception& e) {
+            json error = {{"success", false}, {"error", e.what()}};
+            res.set_content(error.dump(), "application/json");
+        }
+    });
+    
+    server.Patch("/api/fir/:id", [&firSystem](const Request& req, Response& res) {
+        try {
+            json requestData = json::parse(req.body);
+            json response = firSystem.patchFIR(req.path_params.at("id"), requestData);
+            res.set_content(response.dump(), "application/json");
+        } catch (const exception& e) {
+            json error = {{"success", false}, {"error", e.what()}};
+            res.set_content(error.dump(), "application/json");
+        }
+    });
+    
+    server.Delete("/api/fir/:id", [&firSystem](const Request& req, Response& res) {
+        json response = firSystem.deleteFIR(req.path_params.at("id"));
+        res.set_content(response.dump(), "application/json");
+    });
+    
     cout << "✅ Server initialized" << endl;
     cout << "🌐 Listening on http://localhost:8080" << endl;
     cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << endl;
@@ -628,9 +1999,23 @@ int main() {
     cout << "  POST   /api/fir/create          - Create new FIR" << endl;
     cout << "  GET    /api/fir/:id             - Get FIR by ID" << endl;
     cout << "  GET    /api/fir/all             - Get all FIRs" << endl;
+    cout << "  GET    /api/fir/:id/duplicates  - Near-duplicate FIRs" << endl;
     cout << "  GET    /api/fir/search/:keyword - Search FIRs" << endl;
+    cout << "  GET    /api/fir/by-phone/:phone - FIRs by complainant phone" << endl;
+    cout << "  GET    /api/fir/by-email/:email - FIRs by complainant email" << endl;
+    cout << "  GET    /api/districts           - Status counts per district" << endl;
+    cout << "  GET    /api/districts/:district  - District rollup by station" << endl;
+    cout << "  GET    /api/districts/:district/stations/:station - Station FIRs" << endl;
+    cout << "  GET    /api/analytics/rate      - FIRs per station, last min/hour/day" << endl;
+    cout << "  GET    /api/storage/stats       - Hot/cold FIRs, page cache, LSM levels" << endl;
+    cout << "  POST   /api/admin/snapshot      - Export all FIRs to fir_data.snap" << endl;
+    cout << "  GET    /api/admin/snapshot      - Last snapshot progress" << endl;
     cout << "  GET    /api/autocomplete/:prefix - Name autocomplete" << endl;
+    cout << "  POST   /api/ipc/classify        - Predict IPC sections" << endl;
     cout << "  PUT    /api/fir/:id/status      - Update FIR status" << endl;
+    cout << "  PUT    /api/fir/:id             - Replace FIR" << endl;
+    cout << "  PATCH  /api/fir/:id             - Update some FIR fields" << endl;
+    cout << "  DELETE /api/fir/:id             - Delete FIR" << endl;
     cout << "\n💡 Press Ctrl+C to stop the server\n" << endl;
     
     server.listen("0.0.0.0", 8080);
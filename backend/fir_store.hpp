@@ -4,18 +4,62 @@
 #include <unordered_map>
 #include <vector>
 #include <algorithm>
+#include <mutex>
+#include <shared_mutex>
 #include "fir_record.hpp"
 #include "trie.hpp"
 #include "avl_tree.hpp"
 #include "graph.hpp"
+#include "union_find.hpp"
+#include "link_index.hpp"
+#include "object_pool.hpp"
+#include "civil_date.hpp"
+#include "fir_columns.hpp"
+#include "fir_query.hpp"
+#include "stats_cube.hpp"
+#include "sketches.hpp"
 
+using RecordPool = ObjectPool<FIRRecord>;
+using RecordHandle = RecordPool::Handle;
+
+// Primary record store plus every secondary index over it. Records live
+// once, in the pool; indexes hold ids, row numbers or pointers into it.
+//
+// All writes (add, update, patch, remove, setStatus) go through reindex(),
+// which diffs the old and new state of one record and updates each index
+// whose key changed. Callers serialize writes against reads with
+// writeLock()/readLock(), so readers never see a half-applied change.
 class FIRStore {
+public:
+    struct AddResult {
+        RecordHandle handle;
+        FIRRecord* record;
+        std::vector<int> autoLinked; // ids linked via shared suspect details
+    };
+
 private:
-    std::unordered_map<int, FIRRecord*> byId;
+    RecordPool records; // owns every FIRRecord
+    std::unordered_map<int, RecordHandle> byId;
     Trie complainantTrie;
     Trie suspectTrie;
     AVLTree idIndex;
     Graph graph;
+    UnionFind clusters;   // stale while clustersDirty, see caseClusters()
+    bool clustersDirty = false;
+    std::unordered_map<int, std::vector<int>> pendingRelated; // missing id -> ids that list it
+    CaseLinkIndex links;
+    CountedDictionary districtCodes; // district and station names of live records
+    CountedDictionary stationCodes;
+    FIRColumns columns; // filter-scan mirror, row = pool slot
+    BitmapIndex statusIndex;
+    BitmapIndex districtIndex; // keyed by districtCodes
+    BitmapIndex stationIndex;  // keyed by stationCodes
+    TextBitmapIndex locationIndex;
+    DateIndex dateIndex;
+    TextIndex descriptionIndex;
+    StatsCube cube{districtCodes};
+    FIRSketches sketches; // ingest-only streaming top-k / distinct counts
+    mutable std::shared_mutex mutex;
 
     std::string toLower(const std::string& str) {
         std::string result = str;
@@ -23,24 +67,267 @@ private:
         return result;
     }
 
+    // Query indexes, columns and aggregates. before is the row's indexed
+    // state (null on insert), after its new one (null on delete); an index
+    // is only touched when its key differs, so a status change does not
+    // re-tokenize the description.
+    void indexRow(uint32_t row, const FIRRecord* before, const FIRRecord* after) {
+        auto same = [&](auto FIRRecord::*field) {
+            return before && after && before->*field == after->*field;
+        };
+        // A changed name takes a reference to its new code here and drops
+        // the old one at the end, after every index has let go of it
+        bool districtChanged = !same(&FIRRecord::district);
+        bool stationChanged = !same(&FIRRecord::policeStation);
+        if (after && districtChanged) districtCodes.acquire(after->district);
+        if (after && stationChanged) stationCodes.acquire(after->policeStation);
+        uint32_t districtBefore = before ? districtCodes.find(before->district) : 0;
+        uint32_t stationBefore = before ? stationCodes.find(before->policeStation) : 0;
+        uint32_t districtAfter = after ? districtCodes.find(after->district) : 0;
+        uint32_t stationAfter = after ? stationCodes.find(after->policeStation) : 0;
+
+        if (!same(&FIRRecord::status)) {
+            if (before) statusIndex.remove(before->status.code(), row);
+            if (after) statusIndex.add(after->status.code(), row);
+        }
+        if (districtChanged) {
+            if (before) districtIndex.remove(districtBefore, row);
+            if (after) districtIndex.add(districtAfter, row);
+        }
+        if (stationChanged) {
+            if (before) stationIndex.remove(stationBefore, row);
+            if (after) stationIndex.add(stationAfter, row);
+        }
+        if (!same(&FIRRecord::location)) {
+            if (before) locationIndex.remove(before->location, row);
+            if (after) locationIndex.add(after->location, row);
+        }
+
+        int32_t day, month;
+        if (!same(&FIRRecord::date)) {
+            if (before && CivilDate::parse(before->date, day, month)) dateIndex.remove(day, row);
+            if (after && CivilDate::parse(after->date, day, month)) dateIndex.add(day, row);
+        }
+        if (!same(&FIRRecord::description)) {
+            if (before) descriptionIndex.remove(before->description, row);
+            if (after) descriptionIndex.add(after->description, row);
+        }
+
+        if (!after) {
+            columns.erase(row);
+        } else if (!same(&FIRRecord::status) || districtChanged || stationChanged ||
+                   !same(&FIRRecord::date)) {
+            columns.put(row, after->status.code(), districtAfter, stationAfter, after->date);
+        }
+
+        if (!same(&FIRRecord::status) || districtChanged ||
+            !same(&FIRRecord::date) || !same(&FIRRecord::ipcSections)) {
+            if (before) cube.add(*before, districtBefore, -1);
+            if (after) cube.add(*after, districtAfter, 1);
+        }
+
+        if (before && districtChanged) districtCodes.release(districtBefore);
+        if (before && stationChanged) stationCodes.release(stationBefore);
+    }
+
+    // Name tries, id tree, case graph and clusters. Returns the ids the
+    // record was auto-linked to.
+    std::vector<int> indexLinks(FIRRecord* before, FIRRecord* after) {
+        auto same = [&](auto FIRRecord::*field) {
+            return before && after && before->*field == after->*field;
+        };
+        int id = before ? before->id : after->id;
+        if (!same(&FIRRecord::complainant)) {
+            if (before) complainantTrie.remove(before->complainant, id);
+            if (after) complainantTrie.insert(after->complainant, id);
+        }
+        if (!same(&FIRRecord::suspect)) {
+            if (before) suspectTrie.remove(before->suspect, id);
+            if (after) suspectTrie.insert(after->suspect, id);
+        }
+
+        std::vector<int> autoLinked;
+        if (!after) {
+            idIndex.remove(id);
+            links.unlink(*before);
+            // Records still listing id get their edge back if it returns
+            for (int other : graph.neighbors(id)) {
+                if (listsRelated(other, id)) awaitRelated(id, other);
+            }
+            graph.removeVertex(id);
+            clustersDirty = true;
+            return autoLinked;
+        }
+        if (!before) {
+            idIndex.insert(id, after);
+            graph.addVertex(id);
+            clusters.add(id);
+            auto pending = pendingRelated.find(id);
+            if (pending != pendingRelated.end()) {
+                for (int other : pending->second) {
+                    if (!listsRelated(other, id)) continue;
+                    graph.addEdge(id, other);
+                    clusters.unite(id, other);
+                }
+                pendingRelated.erase(pending);
+            }
+        }
+
+        bool edgesRemoved = false;
+        if (before && !same(&FIRRecord::relatedIds)) {
+            for (int relId : before->relatedIds) {
+                if (std::find(after->relatedIds.begin(), after->relatedIds.end(), relId) ==
+                    after->relatedIds.end() && !listsRelated(relId, id)) {
+                    graph.removeEdge(id, relId);
+                    edgesRemoved = true;
+                }
+            }
+        }
+        if (!same(&FIRRecord::relatedIds)) {
+            for (int relId : after->relatedIds) {
+                // An id with no record yet gets no vertex or cluster
+                if (!byId.count(relId)) {
+                    awaitRelated(relId, id);
+                    continue;
+                }
+                graph.addEdge(id, relId);
+                clusters.unite(id, relId);
+            }
+        }
+
+        // Edges from earlier matches stay; they recorded a real overlap
+        if (!same(&FIRRecord::suspect) || !same(&FIRRecord::suspectPhone) ||
+            !same(&FIRRecord::suspectAddress)) {
+            if (before) links.unlink(*before);
+            autoLinked = links.link(*after);
+            for (int linkId : autoLinked) {
+                graph.addEdge(id, linkId);
+                clusters.unite(id, linkId);
+            }
+        }
+
+        if (edgesRemoved) clustersDirty = true;
+        return autoLinked;
+    }
+
+    // Link lister to missing once a record with that id is added
+    void awaitRelated(int missing, int lister) {
+        std::vector<int>& listers = pendingRelated[missing];
+        if (std::find(listers.begin(), listers.end(), lister) == listers.end()) listers.push_back(lister);
+    }
+
+    // True if record id names target in its own relatedIds, which keeps
+    // their edge alive whatever happens to target
+    bool listsRelated(int id, int target) {
+        FIRRecord* record = getById(id);
+        return record && std::find(record->relatedIds.begin(), record->relatedIds.end(), target) !=
+                             record->relatedIds.end();
+    }
+
+    // Union-find cannot split a set, so after edges go away the clusters
+    // are recomputed from the graph: O(V + E), once per cluster read that
+    // follows any number of deletes and unlinks
+    void rebuildClusters() {
+        clusters = UnionFind();
+        for (const auto& entry : byId) clusters.add(entry.first);
+        graph.forEachEdge([&](int a, int b) {
+            if (byId.count(a) && byId.count(b)) clusters.unite(a, b);
+        });
+        clustersDirty = false;
+    }
+
+    std::vector<int> reindex(uint32_t row, FIRRecord* before, FIRRecord* after) {
+        indexRow(row, before, after);
+        return indexLinks(before, after);
+    }
+
+    void sketch(const FIRRecord& record) {
+        int32_t day, month = -1;
+        CivilDate::parse(record.date, day, month);
+        std::vector<std::string> sections;
+        for (const auto& section : record.ipcSections) {
+            sections.push_back(section.str());
+        }
+        sketches.add(month, CaseLinkIndex::normalizeKey(record.suspect), record.location, sections,
+                     record.district, CaseLinkIndex::normalizeText(record.complainant));
+    }
+
 public:
-    void add(FIRRecord* record) {
-        int id = record->id;
-        byId[id] = record;
-        
-        complainantTrie.insert(record->complainant, id);
-        suspectTrie.insert(record->suspect, id);
-        idIndex.insert(id, record);
-        graph.addVertex(id);
-        
-        for (int relId : record->relatedIds) {
-            graph.addEdge(id, relId);
+    // Handlers hold one of these for as long as they use returned records
+    std::shared_lock<std::shared_mutex> readLock() const {
+        return std::shared_lock<std::shared_mutex>(mutex);
+    }
+
+    std::unique_lock<std::shared_mutex> writeLock() {
+        return std::unique_lock<std::shared_mutex>(mutex);
+    }
+
+    // Take ownership of a record and index it. A record with an existing
+    // id replaces the stored one in place.
+    AddResult add(FIRRecord value) {
+        auto existing = byId.find(value.id);
+        if (existing != byId.end()) {
+            RecordHandle handle = existing->second;
+            FIRRecord* record = records.get(handle);
+            FIRRecord before = std::move(*record);
+            *record = std::move(value);
+            std::vector<int> autoLinked = reindex(handle.index, &before, record);
+            return AddResult{handle, record, std::move(autoLinked)};
         }
+
+        int id = value.id;
+        RecordHandle handle = records.emplace(std::move(value));
+        byId.emplace(id, handle);
+        FIRRecord* record = records.get(handle);
+        sketch(*record);
+        std::vector<int> autoLinked = reindex(handle.index, nullptr, record);
+        return AddResult{handle, record, std::move(autoLinked)};
+    }
+
+    // Replace an existing record; null if the id is unknown
+    FIRRecord* update(int id, FIRRecord value) {
+        if (!byId.count(id)) return nullptr;
+        value.id = id;
+        return add(std::move(value)).record;
+    }
+
+    // Edit a record in place through change(record); the id cannot change.
+    // Null if the id is unknown.
+    template <typename F>
+    FIRRecord* patch(int id, F&& change) {
+        auto it = byId.find(id);
+        if (it == byId.end()) return nullptr;
+        FIRRecord* record = records.get(it->second);
+        FIRRecord before = *record;
+        change(*record);
+        record->id = id;
+        reindex(it->second.index, &before, record);
+        return record;
+    }
+
+    // Unindex a record and free its slot; false if the id is unknown
+    bool remove(int id) {
+        auto it = byId.find(id);
+        if (it == byId.end()) return false;
+        RecordHandle handle = it->second;
+        byId.erase(it);
+        reindex(handle.index, records.get(handle), nullptr);
+        records.release(handle);
+        return true;
+    }
+
+    // Status-only patch; touches the status index, columns and cube
+    FIRRecord* setStatus(int id, const InternedString& status) {
+        return patch(id, [&](FIRRecord& record) { record.status = status; });
+    }
+
+    FIRRecord* get(RecordHandle handle) const {
+        return records.get(handle);
     }
 
     FIRRecord* getById(int id) {
         auto it = byId.find(id);
-        return it != byId.end() ? it->second : nullptr;
+        return it != byId.end() ? records.get(it->second) : nullptr;
     }
 
     std::vector<FIRRecord*> searchComplainant(const std::string& name) {
@@ -63,22 +350,23 @@ public:
         return results;
     }
 
+    // Scans the status column; statuses are stored lower case
     std::vector<FIRRecord*> listByStatus(const std::string& status) {
-        std::string lowerStatus = toLower(status);
         std::vector<FIRRecord*> results;
-        for (const auto& pair : byId) {
-            if (toLower(pair.second->status) == lowerStatus) {
-                results.push_back(pair.second);
-            }
+        uint32_t code;
+        if (!internTable().find(toLower(status), code)) return results;
+        for (uint32_t row : columns.rowsWhere(FIRColumns::Status, code)) {
+            results.push_back(records.at(row));
         }
         return results;
     }
 
     std::vector<FIRRecord*> all() {
         std::vector<FIRRecord*> results;
-        for (const auto& pair : byId) {
-            results.push_back(pair.second);
-        }
+        results.reserve(records.size());
+        records.forEach([&](FIRRecord& record) {
+            results.push_back(&record);
+        });
         return results;
     }
 
@@ -91,6 +379,57 @@ public:
         }
         return results;
     }
+
+    Subgraph relatedWithin(int id, int depth, size_t limit) const {
+        return graph.boundedBFS(id, depth, limit);
+    }
+
+    // Rebuilds the clusters if edges were removed since the last call, so
+    // callers hold writeLock()
+    UnionFind& caseClusters() {
+        if (clustersDirty) rebuildClusters();
+        return clusters;
+    }
+
+    const FIRColumns& analytics() const {
+        return columns;
+    }
+
+    const StatsCube& statsCube() const {
+        return cube;
+    }
+
+    const FIRSketches& analyticsSketches() const {
+        return sketches;
+    }
+
+    // Records matching a predicate tree, ordered by id. plan receives the
+    // steps the planner chose.
+    std::vector<FIRRecord*> query(const Predicate& predicate, std::vector<std::string>& plan) const {
+        QuerySource source{
+            statusIndex, districtIndex, stationIndex, districtCodes, stationCodes, locationIndex,
+            dateIndex, descriptionIndex, complainantTrie, suspectTrie, columns,
+            [this](uint32_t row) -> const FIRRecord* { return records.at(row); },
+            [this](int id) -> uint32_t {
+                auto it = byId.find(id);
+                return it != byId.end() ? it->second.index : UINT32_MAX;
+            },
+            records.slotCount()
+        };
+        QueryPlanner planner(source);
+        RowList rows = planner.run(predicate);
+        plan = planner.plan();
+
+        std::vector<FIRRecord*> results;
+        results.reserve(rows.size());
+        for (uint32_t row : rows) {
+            results.push_back(records.at(row));
+        }
+        std::sort(results.begin(), results.end(), [](const FIRRecord* a, const FIRRecord* b) {
+            return a->id < b->id;
+        });
+        return results;
+    }
 };
 
 #endif // FIR_STORE_HPP
@@ -1,33 +1,320 @@
 #ifndef GRAPH_HPP
 #define GRAPH_HPP
 
+#include <algorithm>
+#include <cstdint>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+// Result of a bounded traversal: vertices in BFS order with their hop
+// distance, plus every edge whose endpoints both made it into the result.
+struct Subgraph {
+    std::vector<int> vertices;
+    std::vector<int> depths;
+    std::vector<std::pair<int, int>> edges;
+    bool truncated = false;
+};
+
+// Undirected graph stored as a compressed-sparse-row snapshot over dense
+// vertex ids. New edges land in small per-vertex delta lists and are merged
+// into the CSR arrays once the delta grows past a fraction of the snapshot,
+// so inserts stay cheap and traversals mostly walk contiguous memory.
+// Removing a delta edge erases it directly; removing a CSR edge leaves a
+// tombstone that traversals skip until the next merge drops it. A removed
+// vertex loses its edges and its id; its dense slot stays, empty.
 class Graph {
 private:
-    std::unordered_map<int, std::unordered_set<int>> adj;
+    std::unordered_map<int, uint32_t> index; // FIR id -> dense id
+    std::vector<int> ids;                    // dense id -> FIR id
+
+    std::vector<uint32_t> offsets{0};        // CSR row starts, size = rows + 1
+    std::vector<uint32_t> targets;           // CSR columns, sorted per row
+    std::vector<std::vector<uint32_t>> delta; // edges not yet merged
+    size_t deltaEdges = 0;
+    std::unordered_set<uint64_t> removed;    // tombstoned CSR edges
+
+    static constexpr size_t kMinMergeEdges = 1024;
+
+    // Per-thread buffers so repeated traversals don't reallocate
+    struct BFSScratch {
+        std::vector<uint64_t> visited;
+        std::vector<uint32_t> frontier;
+        std::vector<uint32_t> next;
+        std::vector<uint32_t> order; // boundedBFS: every vertex visited
+    };
+
+    static BFSScratch& scratch() {
+        thread_local BFSScratch s;
+        return s;
+    }
+
+    static bool testBit(const std::vector<uint64_t>& bits, uint32_t i) {
+        return (bits[i >> 6] >> (i & 63)) & 1;
+    }
+
+    static void setBit(std::vector<uint64_t>& bits, uint32_t i) {
+        bits[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+
+    static void clearBit(std::vector<uint64_t>& bits, uint32_t i) {
+        bits[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    }
+
+    size_t csrRows() const {
+        return offsets.size() - 1;
+    }
+
+    static uint64_t edgeKey(uint32_t a, uint32_t b) {
+        if (a > b) std::swap(a, b);
+        return (uint64_t(a) << 32) | b;
+    }
+
+    bool inCSR(uint32_t a, uint32_t b) const {
+        if (a >= csrRows()) return false;
+        auto first = targets.begin() + offsets[a];
+        auto last = targets.begin() + offsets[a + 1];
+        return std::binary_search(first, last, b);
+    }
+
+    bool hasEdge(uint32_t a, uint32_t b) const {
+        if (inCSR(a, b)) return removed.count(edgeKey(a, b)) == 0;
+        const auto& d = delta[a];
+        return std::find(d.begin(), d.end(), b) != d.end();
+    }
+
+    // Rebuild the CSR arrays with the delta lists folded in and tombstoned
+    // edges dropped
+    void merge() {
+        size_t n = ids.size();
+        std::vector<uint32_t> newOffsets(n + 1, 0);
+        for (uint32_t v = 0; v < n; ++v) {
+            newOffsets[v + 1] = newOffsets[v] + degree(v);
+        }
+
+        std::vector<uint32_t> newTargets(newOffsets[n]);
+        for (uint32_t v = 0; v < n; ++v) {
+            auto out = newTargets.begin() + newOffsets[v];
+            forEachNeighbor(v, [&](uint32_t w) { *out++ = w; });
+            std::sort(newTargets.begin() + newOffsets[v], newTargets.begin() + newOffsets[v + 1]);
+        }
+        for (auto& list : delta) {
+            list.clear();
+            list.shrink_to_fit();
+        }
+
+        offsets.swap(newOffsets);
+        targets.swap(newTargets);
+        deltaEdges = 0;
+        removed.clear();
+    }
+
+    void maybeMerge() {
+        if (deltaEdges + 2 * removed.size() >= std::max(kMinMergeEdges, targets.size() / 8)) {
+            merge();
+        }
+    }
+
+    uint32_t addDense(int id) {
+        auto it = index.find(id);
+        if (it != index.end()) return it->second;
+        uint32_t v = static_cast<uint32_t>(ids.size());
+        index.emplace(id, v);
+        ids.push_back(id);
+        delta.emplace_back();
+        return v;
+    }
 
 public:
     void addVertex(int id) {
-        if (adj.find(id) == adj.end()) {
-            adj[id] = std::unordered_set<int>();
-        }
+        addDense(id);
     }
 
     void addEdge(int a, int b) {
-        addVertex(a);
-        addVertex(b);
-        adj[a].insert(b);
-        adj[b].insert(a);
+        uint32_t u = addDense(a);
+        uint32_t v = addDense(b);
+        if (u == v) return;
+        if (removed.erase(edgeKey(u, v))) return; // CSR edge brought back
+        if (hasEdge(u, v)) return;
+
+        delta[u].push_back(v);
+        delta[v].push_back(u);
+        deltaEdges += 2;
+        maybeMerge();
+    }
+
+    void removeEdge(int a, int b) {
+        auto ia = index.find(a);
+        auto ib = index.find(b);
+        if (ia == index.end() || ib == index.end()) return;
+        uint32_t u = ia->second;
+        uint32_t v = ib->second;
+        if (!hasEdge(u, v)) return;
+
+        if (inCSR(u, v)) {
+            removed.insert(edgeKey(u, v));
+        } else {
+            delta[u].erase(std::find(delta[u].begin(), delta[u].end(), v));
+            delta[v].erase(std::find(delta[v].begin(), delta[v].end(), u));
+            deltaEdges -= 2;
+        }
+        maybeMerge();
+    }
+
+    // Drop a vertex and every edge touching it; later lookups of id fail
+    // as if it was never added
+    void removeVertex(int id) {
+        auto it = index.find(id);
+        if (it == index.end()) return;
+        for (int other : neighbors(id)) removeEdge(id, other);
+        index.erase(it);
+    }
+
+    // Fold any pending delta edges into the CSR arrays now
+    void compact() {
+        if (deltaEdges > 0) merge();
+    }
+
+    size_t vertexCount() const {
+        return index.size();
+    }
+
+    size_t edgeCount() const {
+        return (targets.size() + deltaEdges) / 2 - removed.size();
+    }
+
+    uint32_t degree(uint32_t v) const {
+        uint32_t d = static_cast<uint32_t>(delta[v].size());
+        if (v < csrRows()) d += offsets[v + 1] - offsets[v];
+        if (!removed.empty() && v < csrRows()) {
+            for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                d -= removed.count(edgeKey(v, targets[i])) != 0;
+            }
+        }
+        return d;
+    }
+
+    // Visit the dense neighbour ids of dense vertex v
+    template <typename F>
+    void forEachNeighbor(uint32_t v, F&& f) const {
+        if (v < csrRows()) {
+            if (removed.empty()) {
+                for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) f(targets[i]);
+            } else {
+                for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                    if (!removed.count(edgeKey(v, targets[i]))) f(targets[i]);
+                }
+            }
+        }
+        for (uint32_t w : delta[v]) f(w);
+    }
+
+    // Visit every edge once as a pair of FIR ids
+    template <typename F>
+    void forEachEdge(F&& f) const {
+        for (uint32_t v = 0; v < ids.size(); ++v) {
+            forEachNeighbor(v, [&](uint32_t w) {
+                if (v < w) f(ids[v], ids[w]);
+            });
+        }
+    }
+
+    std::vector<int> neighbors(int id) const {
+        std::vector<int> result;
+        auto it = index.find(id);
+        if (it == index.end()) return result;
+        result.reserve(degree(it->second));
+        forEachNeighbor(it->second, [&](uint32_t w) { result.push_back(ids[w]); });
+        return result;
+    }
+
+    // Breadth-first walk from start, stopping after maxDepth hops or once
+    // limit vertices have been collected (start included).
+    Subgraph boundedBFS(int start, int maxDepth, size_t limit) const {
+        Subgraph result;
+        auto startIt = index.find(start);
+        if (startIt == index.end() || limit == 0) {
+            return result;
+        }
+
+        BFSScratch& s = scratch();
+        size_t words = (ids.size() + 63) / 64;
+        if (s.visited.size() < words) {
+            s.visited.resize(words, 0);
+        }
+        s.frontier.clear();
+        std::vector<uint32_t>& order = s.order;
+        order.assign(1, startIt->second);
+        setBit(s.visited, startIt->second);
+        s.frontier.push_back(startIt->second);
+        result.depths.push_back(0);
+
+        for (int depth = 1; depth <= maxDepth && !s.frontier.empty() && !result.truncated; ++depth) {
+            s.next.clear();
+            for (uint32_t u : s.frontier) {
+                forEachNeighbor(u, [&](uint32_t v) {
+                    if (result.truncated || testBit(s.visited, v)) return;
+                    if (order.size() >= limit) {
+                        result.truncated = true;
+                        return;
+                    }
+                    setBit(s.visited, v);
+                    s.next.push_back(v);
+                    order.push_back(v);
+                    result.depths.push_back(depth);
+                });
+                if (result.truncated) break;
+            }
+            s.frontier.swap(s.next);
+        }
+
+        // Emit each induced edge once, from its smaller endpoint
+        result.vertices.reserve(order.size());
+        for (uint32_t u : order) {
+            result.vertices.push_back(ids[u]);
+            forEachNeighbor(u, [&](uint32_t v) {
+                if (ids[u] < ids[v] && testBit(s.visited, v)) {
+                    result.edges.emplace_back(ids[u], ids[v]);
+                }
+            });
+        }
+
+        // Clear only the bits we set so the bitmap is ready for reuse
+        for (uint32_t v : order) {
+            clearBit(s.visited, v);
+        }
+        return result;
     }
 
-    std::vector<int> neighbors(int id) {
-        if (adj.find(id) == adj.end()) {
-            return std::vector<int>();
+    // Full BFS over the dense arrays; returns the number of vertices reached.
+    // Used for throughput measurement and whole-component analytics.
+    size_t reachableFrom(int start) const {
+        auto startIt = index.find(start);
+        if (startIt == index.end()) return 0;
+
+        BFSScratch& s = scratch();
+        size_t words = (ids.size() + 63) / 64;
+        s.visited.assign(std::max(words, s.visited.size()), 0);
+        s.frontier.assign(1, startIt->second);
+        setBit(s.visited, startIt->second);
+
+        size_t reached = 1;
+        while (!s.frontier.empty()) {
+            s.next.clear();
+            for (uint32_t u : s.frontier) {
+                forEachNeighbor(u, [&](uint32_t v) {
+                    if (testBit(s.visited, v)) return;
+                    setBit(s.visited, v);
+                    s.next.push_back(v);
+                    ++reached;
+                });
+            }
+            s.frontier.swap(s.next);
         }
-        return std::vector<int>(adj[id].begin(), adj[id].end());
+
+        std::fill(s.visited.begin(), s.visited.end(), 0);
+        return reached;
     }
 };
 
@@ -0,0 +1,69 @@
+/**
+ * Graph BFS throughput benchmark
+ * Builds a synthetic case-link graph with ~1M edges and measures
+ * insert rate, full-graph BFS edges/sec and bounded related-case queries.
+ *
+ * Compile: g++ -std=c++17 -O2 graph_bench.cpp -o graph_bench
+ * Run: ./graph_bench [vertices] [edges]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include "graph.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int vertices = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int edges = argc > 2 ? std::atoi(argv[2]) : 1000000;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pick(1, vertices);
+
+    Graph graph;
+    auto start = Clock::now();
+    for (int v = 1; v <= vertices; ++v) {
+        graph.addVertex(v);
+    }
+    for (int e = 0; e < edges; ++e) {
+        graph.addEdge(pick(rng), pick(rng));
+    }
+    graph.compact();
+    double buildSecs = secondsSince(start);
+
+    std::cout << "Graph: " << graph.vertexCount() << " vertices, "
+              << graph.edgeCount() << " edges" << std::endl;
+    std::cout << "Build: " << buildSecs << " s ("
+              << static_cast<long>(edges / buildSecs) << " edges/s)" << std::endl;
+
+    const int fullRuns = 10;
+    size_t reached = 0;
+    start = Clock::now();
+    for (int i = 0; i < fullRuns; ++i) {
+        reached += graph.reachableFrom(pick(rng));
+    }
+    double bfsSecs = secondsSince(start);
+    double edgesVisited = 2.0 * graph.edgeCount() * fullRuns;
+    std::cout << "Full BFS: " << (bfsSecs / fullRuns) * 1000 << " ms/run, "
+              << static_cast<long>(edgesVisited / bfsSecs) << " edges/s (reached "
+              << reached / fullRuns << " vertices/run)" << std::endl;
+
+    const int boundedRuns = 100000;
+    size_t collected = 0;
+    start = Clock::now();
+    for (int i = 0; i < boundedRuns; ++i) {
+        collected += graph.boundedBFS(pick(rng), 3, 100).vertices.size();
+    }
+    double boundedSecs = secondsSince(start);
+    std::cout << "Bounded BFS (depth 3, limit 100): "
+              << (boundedSecs / boundedRuns) * 1e6 << " us/query (avg "
+              << collected / boundedRuns << " vertices)" << std::endl;
+
+    return 0;
+}
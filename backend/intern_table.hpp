@@ -0,0 +1,199 @@
+#ifndef INTERN_TABLE_HPP
+#define INTERN_TABLE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Dictionary for closed vocabularies (status, IPC sections). Each distinct
+// value is stored once and gets a dense 32-bit id; ids never change and
+// text never moves, so lookups hand out string_views without copying.
+// Nothing is ever freed, so a value a client can choose freely (district,
+// station, location, tags) must not be interned; see CountedDictionary.
+//
+// Lookups are lock-free: id -> view goes through a fixed directory of
+// blocks that are only ever appended. Interning new text takes a lock.
+class InternTable {
+private:
+    static constexpr size_t kBlockBits = 12;
+    static constexpr size_t kBlockSize = size_t(1) << kBlockBits;
+    static constexpr size_t kMaxBlocks = 4096;     // up to 16M distinct values
+    static constexpr size_t kArenaChunk = 64 * 1024;
+
+    std::atomic<std::string_view*> blocks[kMaxBlocks] = {};
+    std::vector<std::unique_ptr<std::string_view[]>> ownedBlocks;
+    std::vector<std::unique_ptr<char[]>> arena;
+    size_t arenaUsed = kArenaChunk; // forces a chunk on first store
+    std::atomic<uint32_t> count{0};
+
+    std::unordered_map<std::string_view, uint32_t> ids;
+    mutable std::shared_mutex mutex;
+
+    // Copy text into the arena; chunks are never freed or moved
+    std::string_view store(std::string_view text) {
+        if (text.empty()) return std::string_view();
+        if (text.size() > kArenaChunk) {
+            arena.emplace_back(new char[text.size()]);
+            std::memcpy(arena.back().get(), text.data(), text.size());
+            return std::string_view(arena.back().get(), text.size());
+        }
+        if (arenaUsed + text.size() > kArenaChunk) {
+            arena.emplace_back(new char[kArenaChunk]);
+            arenaUsed = 0;
+        }
+        char* dest = arena.back().get() + arenaUsed;
+        std::memcpy(dest, text.data(), text.size());
+        arenaUsed += text.size();
+        return std::string_view(dest, text.size());
+    }
+
+public:
+    InternTable() {
+        intern(""); // id 0 is the empty string
+    }
+
+    InternTable(const InternTable&) = delete;
+    InternTable& operator=(const InternTable&) = delete;
+
+    uint32_t intern(std::string_view text) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = ids.find(text);
+            if (it != ids.end()) return it->second;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(text);
+        if (it != ids.end()) return it->second;
+
+        uint32_t id = count.load(std::memory_order_relaxed);
+        size_t block = id >> kBlockBits;
+        if (block >= kMaxBlocks) {
+            throw std::length_error("intern table full");
+        }
+        if (!blocks[block].load(std::memory_order_relaxed)) {
+            ownedBlocks.emplace_back(new std::string_view[kBlockSize]);
+            blocks[block].store(ownedBlocks.back().get(), std::memory_order_release);
+        }
+
+        std::string_view stored = store(text);
+        blocks[block].load(std::memory_order_relaxed)[id & (kBlockSize - 1)] = stored;
+        ids.emplace(stored, id);
+        count.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    // Id of text if it was interned before; never adds it
+    bool find(std::string_view text, uint32_t& id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(text);
+        if (it == ids.end()) return false;
+        id = it->second;
+        return true;
+    }
+
+    std::string_view lookup(uint32_t id) const {
+        if (id >= count.load(std::memory_order_acquire)) return std::string_view();
+        return blocks[id >> kBlockBits].load(std::memory_order_acquire)[id & (kBlockSize - 1)];
+    }
+
+    size_t size() const {
+        return count.load(std::memory_order_acquire);
+    }
+};
+
+inline InternTable& internTable() {
+    static InternTable table;
+    return table;
+}
+
+// A field value stored as its dictionary id. Equality compares ids; the
+// text is read back through the global intern table.
+class InternedString {
+private:
+    uint32_t id;
+
+public:
+    InternedString() : id(0) {}
+    InternedString(std::string_view text) : id(internTable().intern(text)) {}
+    InternedString(const std::string& text) : InternedString(std::string_view(text)) {}
+    InternedString(const char* text) : InternedString(std::string_view(text)) {}
+
+    std::string_view view() const { return internTable().lookup(id); }
+    std::string str() const { return std::string(view()); }
+    uint32_t code() const { return id; }
+    bool empty() const { return id == 0; }
+
+    bool operator==(const InternedString& other) const { return id == other.id; }
+    bool operator!=(const InternedString& other) const { return id != other.id; }
+};
+
+// Dense codes for an open vocabulary (district or station names) owned by
+// one store. Each code counts the records holding it and is freed, and
+// later reused, when the last one lets go, so memory follows the live
+// data instead of everything ever sent. Not thread-safe; the owner's lock
+// covers it.
+class CountedDictionary {
+public:
+    static constexpr uint32_t kMissing = UINT32_MAX;
+
+private:
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::string_view> text; // code -> key in ids (nodes never move)
+    std::vector<uint32_t> refs;
+    std::vector<uint32_t> freeCodes;
+
+public:
+    // Code for value, adding it if needed; one reference per call
+    uint32_t acquire(std::string_view value) {
+        auto it = ids.find(std::string(value));
+        if (it != ids.end()) {
+            refs[it->second]++;
+            return it->second;
+        }
+        uint32_t code;
+        if (!freeCodes.empty()) {
+            code = freeCodes.back();
+            freeCodes.pop_back();
+        } else {
+            code = static_cast<uint32_t>(text.size());
+            text.emplace_back();
+            refs.push_back(0);
+        }
+        it = ids.emplace(std::string(value), code).first;
+        text[code] = it->first;
+        refs[code] = 1;
+        return code;
+    }
+
+    void release(uint32_t code) {
+        if (code >= refs.size() || refs[code] == 0 || --refs[code] > 0) return;
+        ids.erase(std::string(text[code]));
+        text[code] = std::string_view();
+        freeCodes.push_back(code);
+    }
+
+    // kMissing if no live record holds value
+    uint32_t find(std::string_view value) const {
+        auto it = ids.find(std::string(value));
+        return it != ids.end() ? it->second : kMissing;
+    }
+
+    std::string_view lookup(uint32_t code) const {
+        return code < text.size() ? text[code] : std::string_view();
+    }
+
+    size_t size() const {
+        return ids.size();
+    }
+};
+
+#endif // INTERN_TABLE_HPP
@@ -0,0 +1,127 @@
+#ifndef IPC_CATALOG_HPP
+#define IPC_CATALOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+
+// Law section as a set of views into static (or otherwise owned) text.
+// Keywords are a pointer + count so catalogs of any shape can share the type.
+struct IPCSection {
+    std::string_view section;
+    std::string_view title;
+    std::string_view description;
+    const std::string_view* keywords;
+    size_t keywordCount;
+    std::string_view punishment;
+    std::string_view act = "IPC"; // IPC, BNS, CrPC, ...
+};
+
+namespace ipc_catalog {
+
+inline constexpr std::string_view kw302[] = {"kill", "murder", "death", "homicide", "killing"};
+inline constexpr std::string_view kw304[] = {"kill", "death", "homicide", "culpable"};
+inline constexpr std::string_view kw307[] = {"attempt", "kill", "murder", "try to kill"};
+inline constexpr std::string_view kw323[] = {"hurt", "assault", "hit", "beat", "attack", "injury"};
+inline constexpr std::string_view kw324[] = {"hurt", "weapon", "knife", "assault", "attack"};
+inline constexpr std::string_view kw325[] = {"hurt", "grievous", "serious injury", "assault"};
+inline constexpr std::string_view kw354[] = {"assault", "woman", "modesty", "molestation", "harassment"};
+inline constexpr std::string_view kw376[] = {"rape", "sexual assault", "sexual violence"};
+inline constexpr std::string_view kw379[] = {"theft", "steal", "stealing", "rob", "loot"};
+inline constexpr std::string_view kw380[] = {"theft", "burglary", "house theft", "steal from house"};
+inline constexpr std::string_view kw392[] = {"robbery", "rob", "dacoity", "armed theft", "loot"};
+inline constexpr std::string_view kw420[] = {"cheat", "fraud", "deception", "dishonest", "scam"};
+inline constexpr std::string_view kw425[] = {"damage", "vandalism", "mischief", "destroy property"};
+inline constexpr std::string_view kw427[] = {"damage", "vandalism", "property damage"};
+inline constexpr std::string_view kw504[] = {"insult", "provoke", "abuse", "verbal abuse"};
+inline constexpr std::string_view kw506[] = {"threat", "intimidation", "threaten", "blackmail"};
+inline constexpr std::string_view kw511[] = {"attempt", "trying to commit"};
+
+#define IPC_KEYWORDS(kw) kw, std::size(kw)
+
+inline constexpr IPCSection kSections[] = {
+    {"302", "Murder", "Punishment for murder", IPC_KEYWORDS(kw302), "Death or life imprisonment"},
+    {"304", "Culpable homicide not amounting to murder", "Punishment for culpable homicide", IPC_KEYWORDS(kw304), "Imprisonment up to 10 years or life"},
+    {"307", "Attempt to murder", "Attempt to commit murder", IPC_KEYWORDS(kw307), "Imprisonment up to 10 years"},
+    {"323", "Punishment for voluntarily causing hurt", "Causing hurt voluntarily", IPC_KEYWORDS(kw323), "Imprisonment up to 1 year or fine"},
+    {"324", "Voluntarily causing hurt by dangerous weapons", "Causing hurt with dangerous weapons", IPC_KEYWORDS(kw324), "Imprisonment up to 3 years"},
+    {"325", "Punishment for voluntarily causing grievous hurt", "Causing grievous hurt", IPC_KEYWORDS(kw325), "Imprisonment up to 7 years"},
+    {"354", "Assault or criminal force to woman", "Assault or criminal force with intent to outrage modesty", IPC_KEYWORDS(kw354), "Imprisonment up to 2 years"},
+    {"376", "Punishment for rape", "Sexual assault", IPC_KEYWORDS(kw376), "Imprisonment not less than 10 years, may extend to life"},
+    {"379", "Punishment for theft", "Theft of movable property", IPC_KEYWORDS(kw379), "Imprisonment up to 3 years or fine"},
+    {"380", "Theft in dwelling house", "Theft in a building used as dwelling", IPC_KEYWORDS(kw380), "Imprisonment up to 7 years"},
+    {"392", "Punishment for robbery", "Robbery or dacoity", IPC_KEYWORDS(kw392), "Imprisonment up to 10 years"},
+    {"420", "Cheating and dishonestly inducing delivery of property", "Cheating", IPC_KEYWORDS(kw420), "Imprisonment up to 7 years"},
+    {"425", "Mischief", "Causing damage to property", IPC_KEYWORDS(kw425), "Imprisonment up to 3 months or fine"},
+    {"427", "Mischief causing damage", "Mischief causing damage to property", IPC_KEYWORDS(kw427), "Imprisonment up to 2 years or fine"},
+    {"504", "Intentional insult", "Intentional insult to provoke breach of peace", IPC_KEYWORDS(kw504), "Imprisonment up to 2 years or fine"},
+    {"506", "Punishment for criminal intimidation", "Criminal intimidation", IPC_KEYWORDS(kw506), "Imprisonment up to 2 years or fine"},
+    {"511", "Punishment for attempting to commit offences", "Attempting to commit offences punishable with imprisonment", IPC_KEYWORDS(kw511), "Half of longest term for the offence"}
+};
+
+#undef IPC_KEYWORDS
+
+inline constexpr size_t kSectionCount = std::size(kSections);
+
+// Perfect hash on the section number: FNV-1a with a seed searched at
+// compile time so every section lands in its own slot.
+inline constexpr size_t kSlotCount = 64;
+static_assert((kSlotCount & (kSlotCount - 1)) == 0, "slot count must be a power of two");
+static_assert(kSectionCount <= kSlotCount, "too many sections for the slot table");
+
+constexpr uint32_t hashSection(std::string_view sec, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    for (char ch : sec) {
+        h ^= static_cast<uint8_t>(ch);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+constexpr uint32_t findSeed() {
+    for (uint32_t seed = 0; seed < 100000; ++seed) {
+        bool used[kSlotCount] = {};
+        bool collision = false;
+        for (size_t i = 0; i < kSectionCount && !collision; ++i) {
+            size_t slot = hashSection(kSections[i].section, seed) & (kSlotCount - 1);
+            collision = used[slot];
+            used[slot] = true;
+        }
+        if (!collision) return seed;
+    }
+    return UINT32_MAX;
+}
+
+inline constexpr uint32_t kSeed = findSeed();
+static_assert(kSeed != UINT32_MAX, "no perfect hash seed found for the IPC catalog");
+
+struct SlotTable {
+    int8_t slots[kSlotCount];
+};
+
+constexpr SlotTable buildSlots() {
+    SlotTable table = {};
+    for (size_t slot = 0; slot < kSlotCount; ++slot) table.slots[slot] = -1;
+    for (size_t i = 0; i < kSectionCount; ++i) {
+        table.slots[hashSection(kSections[i].section, kSeed) & (kSlotCount - 1)] = static_cast<int8_t>(i);
+    }
+    return table;
+}
+
+inline constexpr SlotTable kSlots = buildSlots();
+
+// O(1) lookup by section number, e.g. findSection("420"). fir_server checks
+// the sections on every FIR it is sent against this.
+constexpr const IPCSection* findSection(std::string_view sec) {
+    int8_t idx = kSlots.slots[hashSection(sec, kSeed) & (kSlotCount - 1)];
+    return idx >= 0 && kSections[idx].section == sec ? &kSections[idx] : nullptr;
+}
+
+static_assert(findSection("302") == &kSections[0], "perfect hash lookup broken");
+static_assert(findSection("511") == &kSections[kSectionCount - 1], "perfect hash lookup broken");
+static_assert(findSection("999") == nullptr, "perfect hash lookup broken");
+
+} // namespace ipc_catalog
+
+#endif // IPC_CATALOG_HPP
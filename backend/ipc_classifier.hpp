@@ -0,0 +1,197 @@
+#ifndef IPC_CLASSIFIER_HPP
+#define IPC_CLASSIFIER_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Multinomial naive Bayes over incident descriptions, labelled with the IPC
+// sections of stored FIRs. Training is incremental: each labelled FIR only
+// touches the rows of the terms it contains.
+//
+// Layout is term-major: row t holds log(count(t, c) + alpha) for every class
+// c in one contiguous float array. A description becomes a sparse term
+// vector, and scoring is an axpy of those rows into a per-class accumulator,
+// a straight loop over floats that the compiler vectorizes.
+class IPCClassifier {
+private:
+    static constexpr float kAlpha = 1.0f; // Laplace smoothing
+
+    std::unordered_map<std::string, uint32_t> vocab;
+    std::vector<std::string> classes;
+    std::unordered_map<std::string, uint32_t> classIndex;
+
+    size_t stride = 8;                 // floats per row, >= classes.size()
+    std::vector<float> logCounts;      // vocab.size() x stride
+    std::vector<uint32_t> termCounts;  // vocab.size() x stride, raw counts
+    std::vector<double> classTokens;   // tokens seen per class
+    std::vector<uint32_t> classDocs;   // documents seen per class
+    uint32_t totalDocs = 0;
+
+    static std::string stem(std::string word) {
+        static const char* suffixes[] = {"ing", "ed", "es", "s"};
+        for (const char* suffix : suffixes) {
+            size_t len = std::char_traits<char>::length(suffix);
+            if (word.size() > len + 3 && word.compare(word.size() - len, len, suffix) == 0) {
+                word.resize(word.size() - len);
+                break;
+            }
+        }
+        return word;
+    }
+
+    static std::vector<std::string> tokenize(const std::string& text) {
+        static const std::unordered_set<std::string> stopwords = {
+            "the", "and", "was", "were", "with", "his", "her", "him", "she", "they",
+            "them", "from", "that", "this", "have", "had", "has", "for", "who", "when",
+            "then", "there", "into", "are", "but", "not", "our", "your", "someone"
+        };
+        std::vector<std::string> tokens;
+        std::string word;
+        for (size_t i = 0; i <= text.size(); ++i) {
+            unsigned char ch = i < text.size() ? text[i] : ' ';
+            if (std::isalnum(ch)) {
+                word.push_back(static_cast<char>(std::tolower(ch)));
+            } else if (!word.empty()) {
+                if (word.size() > 2 && !stopwords.count(word)) tokens.push_back(stem(word));
+                word.clear();
+            }
+        }
+        return tokens;
+    }
+
+    // Sparse term-frequency vector, adding unseen terms to the vocabulary
+    std::vector<std::pair<uint32_t, float>> vectorize(const std::string& text) {
+        std::unordered_map<uint32_t, float> tf;
+        for (const auto& token : tokenize(text)) {
+            auto it = vocab.find(token);
+            if (it == vocab.end()) {
+                uint32_t id = static_cast<uint32_t>(vocab.size());
+                it = vocab.emplace(token, id).first;
+                logCounts.resize(logCounts.size() + stride, std::log(kAlpha));
+                termCounts.resize(termCounts.size() + stride, 0);
+            }
+            tf[it->second] += 1.0f;
+        }
+        return std::vector<std::pair<uint32_t, float>>(tf.begin(), tf.end());
+    }
+
+    // Re-lay rows out with a wider stride when classes outgrow it
+    void widen() {
+        size_t newStride = stride * 2;
+        std::vector<float> newLog(vocab.size() * newStride, std::log(kAlpha));
+        std::vector<uint32_t> newCounts(vocab.size() * newStride, 0);
+        for (size_t t = 0; t < vocab.size(); ++t) {
+            std::copy_n(&logCounts[t * stride], stride, &newLog[t * newStride]);
+            std::copy_n(&termCounts[t * stride], stride, &newCounts[t * newStride]);
+        }
+        logCounts.swap(newLog);
+        termCounts.swap(newCounts);
+        stride = newStride;
+    }
+
+    uint32_t classFor(const std::string& label) {
+        auto it = classIndex.find(label);
+        if (it != classIndex.end()) return it->second;
+        if (classes.size() == stride) widen();
+        uint32_t c = static_cast<uint32_t>(classes.size());
+        classIndex.emplace(label, c);
+        classes.push_back(label);
+        classTokens.push_back(0);
+        classDocs.push_back(0);
+        return c;
+    }
+
+public:
+    // Add one labelled description; every label counts as a class
+    void train(const std::string& text, const std::vector<std::string>& labels) {
+        if (labels.empty()) return;
+        std::vector<uint32_t> labelIds;
+        for (const auto& label : labels) {
+            labelIds.push_back(classFor(label));
+        }
+        auto terms = vectorize(text);
+
+        double tokens = 0;
+        for (const auto& term : terms) tokens += term.second;
+        for (uint32_t c : labelIds) {
+            for (const auto& term : terms) {
+                size_t cell = term.first * stride + c;
+                termCounts[cell] += static_cast<uint32_t>(term.second);
+                logCounts[cell] = std::log(termCounts[cell] + kAlpha);
+            }
+            classTokens[c] += tokens;
+            classDocs[c]++;
+        }
+        totalDocs++;
+    }
+
+    // Top-k (label, probability) pairs, probabilities normalized over all classes
+    std::vector<std::pair<std::string, double>> predict(const std::string& text, size_t k) const {
+        std::vector<std::pair<std::string, double>> results;
+        if (classes.empty()) return results;
+
+        // Const lookup of known terms only
+        std::unordered_map<uint32_t, float> tf;
+        for (const auto& token : tokenize(text)) {
+            auto it = vocab.find(token);
+            if (it != vocab.end()) tf[it->second] += 1.0f;
+        }
+        if (tf.empty()) return results;
+
+        size_t n = classes.size();
+        std::vector<float> acc(stride, 0.0f);
+        float docTokens = 0;
+        for (const auto& term : tf) {
+            const float* row = &logCounts[term.first * stride];
+            float weight = term.second;
+            float* out = acc.data();
+            for (size_t c = 0; c < stride; ++c) {
+                out[c] += weight * row[c];
+            }
+            docTokens += weight;
+        }
+
+        double vocabSize = static_cast<double>(vocab.size());
+        std::vector<double> scores(n);
+        double best = -INFINITY;
+        for (size_t c = 0; c < n; ++c) {
+            scores[c] = std::log(static_cast<double>(classDocs[c]) / totalDocs)
+                      + acc[c]
+                      - docTokens * std::log(classTokens[c] + kAlpha * vocabSize);
+            best = std::max(best, scores[c]);
+        }
+
+        double norm = 0;
+        for (double& score : scores) {
+            score = std::exp(score - best);
+            norm += score;
+        }
+
+        std::vector<size_t> order(n);
+        for (size_t c = 0; c < n; ++c) order[c] = c;
+        size_t top = std::min(k, n);
+        std::partial_sort(order.begin(), order.begin() + top, order.end(), [&](size_t a, size_t b) {
+            return scores[a] > scores[b];
+        });
+        for (size_t i = 0; i < top; ++i) {
+            results.emplace_back(classes[order[i]], scores[order[i]] / norm);
+        }
+        return results;
+    }
+
+    size_t documentCount() const {
+        return totalDocs;
+    }
+
+    size_t classCount() const {
+        return classes.size();
+    }
+};
+
+#endif // IPC_CLASSIFIER_HPP
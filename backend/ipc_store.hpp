@@ -1,77 +1,380 @@
 #ifndef IPC_STORE_HPP
 #define IPC_STORE_HPP
 
-#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <set>
 #include <unordered_set>
+#include <vector>
 #include "fir_record.hpp"
 #include "trie.hpp"
+#include "ipc_catalog.hpp"
+#include "ipc_suggester.hpp"
+#include "rcu_ptr.hpp"
 
-class IPCStore {
+// One immutable version of the law catalog together with everything derived
+// from it: keyword trie, Aho-Corasick suggester, section lookup table and the
+// serialized /api/ipc/all body. Built off the request path, then published.
+//
+// The section lookup is a perfect hash built per version, the runtime
+// counterpart of ipc_catalog::findSection for catalogs loaded from a file
+// (hash and displace): keys are spread over buckets, and each bucket gets
+// the first seed that sends all of its keys to free slots. A lookup is
+// two hashes and one compare, with no allocation. If no seeds are found
+// within the bounds, lookups fall back to a linear scan.
+class IPCCatalog {
 private:
+    std::deque<std::string> strings;         // owns text for loaded catalogs
+    std::vector<std::string_view> keywordViews;
     std::vector<IPCSection> sections;
+    std::vector<uint32_t> bucketSeeds;
+    std::vector<int32_t> slots; // section index, -1 = empty; size a power of two, empty = scan
     Trie keywordTrie;
+    std::unique_ptr<IPCSuggester> suggester;
+    std::string allSectionsBody;
+    uint64_t versionNumber;
+
+    std::string_view own(const std::string& text) {
+        strings.push_back(text);
+        return strings.back();
+    }
+
+    static constexpr uint32_t kMaxSeed = 4096;  // per bucket, per table size
+    static constexpr int kMaxGrowth = 4;        // table doublings before falling back
 
-    void initializeSections() {
-        sections = {
-            {"302", "Murder", "Punishment for murder", {"kill", "murder", "death", "homicide", "killing"}, "Death or life imprisonment"},
-            {"304", "Culpable homicide not amounting to murder", "Punishment for culpable homicide", {"kill", "death", "homicide", "culpable"}, "Imprisonment up to 10 years or life"},
-            {"307", "Attempt to murder", "Attempt to commit murder", {"attempt", "kill", "murder", "try to kill"}, "Imprisonment up to 10 years"},
-            {"323", "Punishment for voluntarily causing hurt", "Causing hurt voluntarily", {"hurt", "assault", "hit", "beat", "attack", "injury"}, "Imprisonment up to 1 year or fine"},
-            {"324", "Voluntarily causing hurt by dangerous weapons", "Causing hurt with dangerous weapons", {"hurt", "weapon", "knife", "assault", "attack"}, "Imprisonment up to 3 years"},
-            {"325", "Punishment for voluntarily causing grievous hurt", "Causing grievous hurt", {"hurt", "grievous", "serious injury", "assault"}, "Imprisonment up to 7 years"},
-            {"354", "Assault or criminal force to woman", "Assault or criminal force with intent to outrage modesty", {"assault", "woman", "modesty", "molestation", "harassment"}, "Imprisonment up to 2 years"},
-            {"376", "Punishment for rape", "Sexual assault", {"rape", "sexual assault", "sexual violence"}, "Imprisonment not less than 10 years, may extend to life"},
-            {"379", "Punishment for theft", "Theft of movable property", {"theft", "steal", "stealing", "rob", "loot"}, "Imprisonment up to 3 years or fine"},
-            {"380", "Theft in dwelling house", "Theft in a building used as dwelling", {"theft", "burglary", "house theft", "steal from house"}, "Imprisonment up to 7 years"},
-            {"392", "Punishment for robbery", "Robbery or dacoity", {"robbery", "rob", "dacoity", "armed theft", "loot"}, "Imprisonment up to 10 years"},
-            {"420", "Cheating and dishonestly inducing delivery of property", "Cheating", {"cheat", "fraud", "deception", "dishonest", "scam"}, "Imprisonment up to 7 years"},
-            {"425", "Mischief", "Causing damage to property", {"damage", "vandalism", "mischief", "destroy property"}, "Imprisonment up to 3 months or fine"},
-            {"427", "Mischief causing damage", "Mischief causing damage to property", {"damage", "vandalism", "property damage"}, "Imprisonment up to 2 years or fine"},
-            {"504", "Intentional insult", "Intentional insult to provoke breach of peace", {"insult", "provoke", "abuse", "verbal abuse"}, "Imprisonment up to 2 years or fine"},
-            {"506", "Punishment for criminal intimidation", "Criminal intimidation", {"threat", "intimidation", "threaten", "blackmail"}, "Imprisonment up to 2 years or fine"},
-            {"511", "Punishment for attempting to commit offences", "Attempting to commit offences punishable with imprisonment", {"attempt", "trying to commit"}, "Half of longest term for the offence"}
+    // FNV-1a of the act length, act and section. The length keeps act
+    // names containing ':' from aliasing another act:section pair.
+    static uint32_t sectionHash(std::string_view act, std::string_view sec, uint32_t seed) {
+        uint32_t h = 2166136261u ^ seed;
+        auto mix = [&h](char ch) {
+            h ^= static_cast<uint8_t>(ch);
+            h *= 16777619u;
         };
-        
-        buildIndex();
+        for (int shift = 0; shift < 32; shift += 8) mix(static_cast<char>(act.size() >> shift));
+        for (char ch : act) mix(ch);
+        for (char ch : sec) mix(ch);
+        h ^= h >> 15; // FNV's low bits mix poorly
+        return h;
+    }
+
+    size_t bucketOf(std::string_view act, std::string_view sec) const {
+        return sectionHash(act, sec, 0) % bucketSeeds.size();
+    }
+
+    size_t slotOf(std::string_view act, std::string_view sec, uint32_t seed) const {
+        return sectionHash(act, sec, seed) & (slots.size() - 1);
+    }
+
+    // Place every bucket in a table of slotCount slots; false if some
+    // bucket finds no seed within kMaxSeed
+    bool placeBuckets(const std::vector<std::vector<size_t>>& buckets, size_t slotCount) {
+        slots.assign(slotCount, -1);
+        // Largest buckets first, while most slots are free
+        std::vector<size_t> order(buckets.size());
+        for (size_t b = 0; b < order.size(); ++b) order[b] = b;
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+        std::vector<size_t> taken;
+        for (size_t b : order) {
+            if (buckets[b].empty()) break;
+            bool placed = false;
+            for (uint32_t seed = 1; seed <= kMaxSeed && !placed; ++seed) {
+                taken.clear();
+                for (size_t idx : buckets[b]) {
+                    size_t slot = slotOf(sections[idx].act, sections[idx].section, seed);
+                    if (slots[slot] >= 0 || std::find(taken.begin(), taken.end(), slot) != taken.end()) break;
+                    taken.push_back(slot);
+                }
+                if (taken.size() < buckets[b].size()) continue;
+                for (size_t k = 0; k < taken.size(); ++k) slots[taken[k]] = static_cast<int32_t>(buckets[b][k]);
+                bucketSeeds[b] = seed;
+                placed = true;
+            }
+            if (!placed) return false;
+        }
+        return true;
+    }
+
+    // Perfect hash over the sections; a repeated act + section keeps the
+    // first entry, as the map this replaced did
+    void buildLookup() {
+        bucketSeeds.assign(sections.size() / 4 + 1, 0);
+        std::vector<std::vector<size_t>> buckets(bucketSeeds.size());
+        std::set<std::pair<std::string_view, std::string_view>> seen;
+        for (size_t idx = 0; idx < sections.size(); ++idx) {
+            const IPCSection& section = sections[idx];
+            if (seen.emplace(section.act, section.section).second) {
+                buckets[bucketOf(section.act, section.section)].push_back(idx);
+            }
+        }
+
+        size_t slotCount = 8;
+        while (slotCount < 2 * sections.size()) slotCount *= 2;
+        for (int attempt = 0; attempt <= kMaxGrowth; ++attempt, slotCount *= 2) {
+            if (placeBuckets(buckets, slotCount)) return;
+        }
+        slots.clear();
+        std::cerr << "Catalog version " << versionNumber << ": no perfect hash, section lookups scan" << std::endl;
+    }
+
+    // Checked before any field is read, since asString() on an object or
+    // array throws
+    static bool validEntry(const Json::Value& item, std::string& error) {
+        if (!item.isObject()) {
+            error = "not an object";
+            return false;
+        }
+        if (!item["section"].isString()) {
+            error = "no section number";
+            return false;
+        }
+        for (const char* field : {"act", "title", "description", "punishment"}) {
+            if (item.isMember(field) && !item[field].isString()) {
+                error = std::string(field) + " must be a string";
+                return false;
+            }
+        }
+        const Json::Value& keywords = item["keywords"];
+        if (item.isMember("keywords") && !keywords.isArray()) {
+            error = "keywords must be an array";
+            return false;
+        }
+        for (const auto& kw : keywords) {
+            if (!kw.isString()) {
+                error = "keywords must be strings";
+                return false;
+            }
+        }
+        return true;
     }
 
     void buildIndex() {
+        Json::Value arr(Json::arrayValue);
         for (size_t idx = 0; idx < sections.size(); ++idx) {
-            for (const auto& kw : sections[idx].keywords) {
-                keywordTrie.insert(kw, static_cast<int>(idx));
+            const IPCSection& section = sections[idx];
+            for (size_t k = 0; k < section.keywordCount; ++k) {
+                keywordTrie.insert(std::string(section.keywords[k]), static_cast<int>(idx));
             }
+            arr.append(toJson(section));
         }
+        suggester.reset(new IPCSuggester(sections.data(), sections.size()));
+        buildLookup();
+
+        Json::Value response;
+        response["success"] = true;
+        response["version"] = static_cast<Json::UInt64>(versionNumber);
+        response["sections"] = arr;
+
+        Json::StreamWriterBuilder builder;
+        allSectionsBody = Json::writeString(builder, response);
     }
 
 public:
-    IPCStore() {
-        initializeSections();
+    explicit IPCCatalog(uint64_t version) : versionNumber(version) {}
+
+    // Catalog compiled into the binary
+    static std::unique_ptr<IPCCatalog> builtin(uint64_t version) {
+        std::unique_ptr<IPCCatalog> catalog(new IPCCatalog(version));
+        catalog->sections.assign(std::begin(ipc_catalog::kSections), std::end(ipc_catalog::kSections));
+        catalog->buildIndex();
+        return catalog;
     }
 
-    std::vector<IPCSection> searchByKeyword(const std::string& query) {
+    // Catalog from a JSON data file: {"sections": [{"act", "section", "title",
+    // "description", "punishment", "keywords": [...]}, ...]}. Every field but
+    // section is optional; each one present must be a string, keywords an
+    // array of strings. Returns null and sets error if the file is
+    // unreadable or malformed.
+    static std::unique_ptr<IPCCatalog> fromFile(const std::string& path, uint64_t version, std::string& error) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            error = "cannot open " + path;
+            return nullptr;
+        }
+
+        Json::Value root;
+        Json::CharReaderBuilder reader;
+        if (!Json::parseFromStream(reader, file, &root, &error)) {
+            return nullptr;
+        }
+        const Json::Value& list = root["sections"];
+        if (!list.isArray() || list.empty()) {
+            error = "no sections in " + path;
+            return nullptr;
+        }
+
+        size_t keywordTotal = 0;
+        for (Json::ArrayIndex i = 0; i < list.size(); ++i) {
+            if (!validEntry(list[i], error)) {
+                error = "section entry " + std::to_string(i) + ": " + error;
+                return nullptr;
+            }
+            keywordTotal += list[i]["keywords"].size();
+        }
+
+        std::unique_ptr<IPCCatalog> catalog(new IPCCatalog(version));
+        // Sized up front so keyword pointers stay valid
+        catalog->keywordViews.reserve(keywordTotal);
+
+        for (const auto& item : list) {
+            IPCSection section{};
+            section.act = catalog->own(item.get("act", "IPC").asString());
+            section.section = catalog->own(item["section"].asString());
+            section.title = catalog->own(item["title"].asString());
+            section.description = catalog->own(item["description"].asString());
+            section.punishment = catalog->own(item["punishment"].asString());
+            section.keywords = catalog->keywordViews.data() + catalog->keywordViews.size();
+            for (const auto& kw : item["keywords"]) {
+                catalog->keywordViews.push_back(catalog->own(kw.asString()));
+            }
+            section.keywordCount = item["keywords"].size();
+            catalog->sections.push_back(section);
+        }
+        catalog->buildIndex();
+        return catalog;
+    }
+
+    std::vector<const IPCSection*> searchByKeyword(const std::string& query) const {
         std::vector<int> indices = keywordTrie.startsWith(query);
         std::unordered_set<int> uniqueIndices(indices.begin(), indices.end());
-        
-        std::vector<IPCSection> results;
+
+        std::vector<const IPCSection*> results;
         for (int idx : uniqueIndices) {
             if (idx >= 0 && idx < static_cast<int>(sections.size())) {
-                results.push_back(sections[idx]);
+                results.push_back(&sections[idx]);
             }
         }
         return results;
     }
 
-    std::vector<IPCSection> getAll() {
-        return sections;
+    std::vector<SectionMatch> suggestSections(const std::string& text, size_t limit) const {
+        return suggester->suggest(text, limit);
+    }
+
+    // Complete /api/ipc/all response body, built once per version
+    const std::string& allSectionsJson() const {
+        return allSectionsBody;
+    }
+
+    // Section by act and number; null if this version has none
+    const IPCSection* getBySection(std::string_view sec, std::string_view act = "IPC") const {
+        if (slots.empty()) {
+            for (const IPCSection& section : sections) {
+                if (section.section == sec && section.act == act) return &section;
+            }
+            return nullptr;
+        }
+        int32_t idx = slots[slotOf(act, sec, bucketSeeds[bucketOf(act, sec)])];
+        if (idx < 0) return nullptr;
+        const IPCSection& section = sections[idx];
+        return section.section == sec && section.act == act ? &section : nullptr;
+    }
+
+    size_t size() const {
+        return sections.size();
+    }
+
+    uint64_t version() const {
+        return versionNumber;
+    }
+};
+
+// Holds the live catalog. Readers take a snapshot with current() and keep
+// it for the whole request, so a reload never changes data mid-request and
+// never blocks a reader. An optional watcher thread polls the data file and
+// publishes a freshly built catalog when it changes.
+class IPCStore {
+private:
+    RcuPtr<IPCCatalog> live;
+    std::atomic<uint64_t> nextVersion{1};
+    std::string catalogPath;
+
+    std::thread watcher;
+    std::mutex watcherMutex;
+    std::condition_variable watcherWake;
+    bool stopping = false;
+
+public:
+    using Snapshot = RcuPtr<IPCCatalog>::ReadGuard;
+
+    IPCStore() {
+        live.publish(IPCCatalog::builtin(nextVersion++));
+    }
+
+    ~IPCStore() {
+        stopWatching();
+    }
+
+    Snapshot current() const {
+        return live.read();
+    }
+
+    // Rebuild from the data file and swap it in. On failure the current
+    // catalog stays live.
+    bool reload(std::string& error) {
+        if (catalogPath.empty()) {
+            error = "no catalog file configured";
+            return false;
+        }
+        std::unique_ptr<IPCCatalog> catalog;
+        try {
+            catalog = IPCCatalog::fromFile(catalogPath, nextVersion++, error);
+        } catch (const std::exception& e) {
+            // Runs on the watcher thread; an escaping exception would
+            // terminate the server
+            error = e.what();
+        }
+        if (!catalog) return false;
+        size_t count = catalog->size();
+        live.publish(std::move(catalog));
+        std::cout << "Loaded " << count << " law sections from " << catalogPath << std::endl;
+        return true;
     }
 
-    IPCSection* getBySection(const std::string& sec) {
-        for (auto& section : sections) {
-            if (section.section == sec) {
-                return &section;
+    // Load path now, then poll its modification time every interval
+    void watch(const std::string& path, std::chrono::milliseconds interval) {
+        catalogPath = path;
+        std::error_code ec;
+        auto lastWrite = std::filesystem::last_write_time(path, ec);
+        if (!ec) {
+            std::string error;
+            if (!reload(error)) std::cerr << "Catalog load failed: " << error << std::endl;
+        }
+
+        watcher = std::thread([this, path, interval, lastWrite]() mutable {
+            std::unique_lock<std::mutex> lock(watcherMutex);
+            while (!watcherWake.wait_for(lock, interval, [this] { return stopping; })) {
+                std::error_code statError;
+                auto stamp = std::filesystem::last_write_time(path, statError);
+                if (statError || stamp == lastWrite) continue;
+                lastWrite = stamp;
+
+                lock.unlock();
+                std::string error;
+                if (!reload(error)) std::cerr << "Catalog reload failed: " << error << std::endl;
+                lock.lock();
             }
+        });
+    }
+
+    void stopWatching() {
+        {
+            std::lock_guard<std::mutex> lock(watcherMutex);
+            stopping = true;
         }
-        return nullptr;
+        watcherWake.notify_all();
+        if (watcher.joinable()) watcher.join();
     }
 };
 
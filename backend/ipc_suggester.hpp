@@ -0,0 +1,70 @@
+#ifndef IPC_SUGGESTER_HPP
+#define IPC_SUGGESTER_HPP
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "aho_corasick.hpp"
+#include "ipc_catalog.hpp"
+
+// A section suggested for a piece of free text, with the keywords that hit
+struct SectionMatch {
+    const IPCSection* section = nullptr;
+    int score = 0;
+    std::vector<std::string_view> matchedKeywords;
+};
+
+// Ranks catalog sections for free text with one Aho-Corasick pass over
+// every keyword of every section. Each distinct keyword scores its word
+// count, so phrases like "sexual assault" outweigh a bare "assault".
+class IPCSuggester {
+private:
+    const IPCSection* sections;
+    size_t sectionCount;
+    AhoCorasick matcher;
+    std::vector<size_t> patternSection;             // pattern id -> section index
+    std::vector<std::string_view> patternKeyword;   // pattern id -> keyword
+
+public:
+    IPCSuggester(const IPCSection* secs, size_t count) : sections(secs), sectionCount(count) {
+        for (size_t idx = 0; idx < count; ++idx) {
+            for (size_t k = 0; k < secs[idx].keywordCount; ++k) {
+                std::string_view kw = secs[idx].keywords[k];
+                if (matcher.addPattern(std::string(kw)) >= 0) {
+                    patternSection.push_back(idx);
+                    patternKeyword.push_back(kw);
+                }
+            }
+        }
+        matcher.build();
+    }
+
+    std::vector<SectionMatch> suggest(const std::string& text, size_t limit) const {
+        std::vector<bool> seen(patternKeyword.size(), false);
+        std::vector<SectionMatch> bySection(sectionCount);
+        matcher.scan(text, [&](int patternId) {
+            if (seen[patternId]) return;
+            seen[patternId] = true;
+            std::string_view kw = patternKeyword[patternId];
+            SectionMatch& match = bySection[patternSection[patternId]];
+            match.score += 1 + static_cast<int>(std::count(kw.begin(), kw.end(), ' '));
+            match.matchedKeywords.push_back(kw);
+        });
+
+        std::vector<SectionMatch> results;
+        for (size_t idx = 0; idx < sectionCount; ++idx) {
+            if (bySection[idx].score > 0) {
+                bySection[idx].section = &sections[idx];
+                results.push_back(std::move(bySection[idx]));
+            }
+        }
+        std::stable_sort(results.begin(), results.end(), [](const SectionMatch& a, const SectionMatch& b) {
+            return a.score > b.score;
+        });
+        if (results.size() > limit) results.resize(limit);
+        return results;
+    }
+};
+
+#endif // IPC_SUGGESTER_HPP
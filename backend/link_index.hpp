@@ -0,0 +1,123 @@
+#ifndef LINK_INDEX_HPP
+#define LINK_INDEX_HPP
+
+#include <cctype>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "fir_record.hpp"
+
+// Inverted indexes from normalized suspect name / phone / address to the
+// records that mention them. Each key keeps only its first (anchor) and most
+// recent record, so a new record links to at most two cases per key and
+// discovery stays O(1) amortized no matter how many records share a suspect.
+// Linking every record to the anchor keeps the group within two hops.
+class CaseLinkIndex {
+private:
+    struct Posting {
+        int anchor;
+        int latest;
+        size_t count;
+    };
+
+    std::unordered_map<std::string, Posting> bySuspect;
+    std::unordered_map<std::string, Posting> byPhone;
+    std::unordered_map<std::string, Posting> byAddress;
+
+public:
+    // Lowercase, keep letters/digits, collapse everything else to one space
+    static std::string normalizeText(const std::string& str) {
+        std::string result;
+        result.reserve(str.size());
+        for (unsigned char ch : str) {
+            if (std::isalnum(ch)) {
+                result.push_back(static_cast<char>(std::tolower(ch)));
+            } else if (!result.empty() && result.back() != ' ') {
+                result.push_back(' ');
+            }
+        }
+        if (!result.empty() && result.back() == ' ') result.pop_back();
+        return result;
+    }
+
+    static std::string normalizeKey(const std::string& value) {
+        static const std::unordered_set<std::string> placeholders = {
+            "unknown", "na", "n a", "none", "nil", "not known", "unidentified"
+        };
+        std::string key = normalizeText(value);
+        return placeholders.count(key) ? std::string() : key;
+    }
+
+private:
+    // Digits only, last 10 so "+91 98765-43210" and "9876543210" agree
+    static std::string normalizePhone(const std::string& phone) {
+        std::string digits;
+        for (unsigned char ch : phone) {
+            if (std::isdigit(ch)) digits.push_back(static_cast<char>(ch));
+        }
+        if (digits.size() < 7) return std::string();
+        return digits.size() > 10 ? digits.substr(digits.size() - 10) : digits;
+    }
+
+    static void collect(std::unordered_map<std::string, Posting>& index,
+                        const std::string& key, int id, std::vector<int>& links) {
+        if (key.empty()) return;
+        auto it = index.find(key);
+        if (it == index.end()) {
+            index.emplace(key, Posting{id, id, 1});
+            return;
+        }
+        Posting& posting = it->second;
+        for (int target : {posting.anchor, posting.latest}) {
+            if (target == id) continue;
+            bool seen = false;
+            for (int existing : links) {
+                if (existing == target) { seen = true; break; }
+            }
+            if (!seen) links.push_back(target);
+        }
+        posting.latest = id;
+        posting.count++;
+    }
+
+    static void drop(std::unordered_map<std::string, Posting>& index, const std::string& key, int id) {
+        if (key.empty()) return;
+        auto it = index.find(key);
+        if (it == index.end()) return;
+        Posting& posting = it->second;
+        if (posting.anchor != id && posting.latest != id) {
+            posting.count--; // a middle record; nothing here points at it
+        } else if (--posting.count == 0 || posting.anchor == posting.latest) {
+            // Only the endpoints are remembered, so when the sole remembered
+            // record goes the rest of the group can no longer be reached
+            index.erase(it);
+            return;
+        } else if (posting.anchor == id) {
+            posting.anchor = posting.latest;
+        } else {
+            posting.latest = posting.anchor;
+        }
+    }
+
+public:
+    // Register a record and return the ids of existing records it should
+    // be linked to
+    std::vector<int> link(const FIRRecord& record) {
+        std::vector<int> links;
+        collect(bySuspect, normalizeKey(record.suspect), record.id, links);
+        collect(byPhone, normalizePhone(record.suspectPhone), record.id, links);
+        collect(byAddress, normalizeKey(record.suspectAddress), record.id, links);
+        return links;
+    }
+
+    // Forget a record (before it is deleted or its suspect details change)
+    // so later records are not linked to it
+    void unlink(const FIRRecord& record) {
+        drop(bySuspect, normalizeKey(record.suspect), record.id);
+        drop(byPhone, normalizePhone(record.suspectPhone), record.id);
+        drop(byAddress, normalizeKey(record.suspectAddress), record.id);
+    }
+};
+
+#endif // LINK_INDEX_HPP
@@ -0,0 +1,198 @@
+/**
+ * LSMStore benchmark and recovery check
+ * Writes synthetic FIR-like records with overwrites and deletes, then
+ * measures point lookups (time and block reads per lookup), checks that a
+ * snapshot keeps its view through later writes and compactions, reopens
+ * the store and verifies every key against an in-memory model. Exits
+ * non-zero on any mismatch.
+ *
+ * Compile: g++ -std=c++17 -O2 lsm_bench.cpp -o lsm_bench -lpthread
+ * Run: ./lsm_bench [records] [directory]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include "lsm_store.hpp"
+
+static const char* kDistricts[] = {"Pune", "Mumbai", "Nagpur", "Nashik", "Thane"};
+static const char* kStatuses[] = {"pending", "under_investigation", "closed"};
+static const char* kWords[] = {"phone", "stolen", "market", "bike", "night", "bag", "chain", "bus",
+                               "threat", "fraud", "bank", "card", "house", "broken", "window"};
+
+static std::string recordValue(size_t id, std::mt19937& rng) {
+    std::string value = "{\"id\":\"FIR-" + std::to_string(id) + "\",\"district\":\"" + kDistricts[rng() % 5] +
+                        "\",\"status\":\"" + kStatuses[rng() % 3] + "\",\"complainantPhone\":\"9" +
+                        std::to_string(100000000 + rng() % 900000000) + "\",\"incidentDescription\":\"";
+    for (int w = 0; w < 40; ++w) {
+        value += kWords[rng() % 15];
+        value += ' ';
+    }
+    return value + "\"}";
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void printLevels(const LSMStore::Stats& stats) {
+    std::cout << "Levels:";
+    for (int level = 0; level < LSMStore::kLevels; ++level) {
+        if (!stats.tablesPerLevel[level]) continue;
+        std::cout << " L" << level << "=" << stats.tablesPerLevel[level] << " tables/"
+                  << stats.bytesPerLevel[level] / (1024.0 * 1024.0) << " MiB";
+    }
+    std::cout << "; flushes " << stats.flushes << ", compactions " << stats.compactions << ", compacted "
+              << stats.bytesCompacted / (1024.0 * 1024.0) << " MiB" << std::endl;
+}
+
+// Compare an ordered scan with the model; returns the mismatch count
+template <typename Scan>
+static int verifyScan(const char* what, Scan&& scan, const std::map<std::string, std::string>& model) {
+    int failures = 0;
+    size_t seen = 0;
+    auto expected = model.begin();
+    std::string error;
+    bool complete = scan([&](const std::string& key, const std::string& value) {
+        if (expected == model.end() || expected->first != key || expected->second != value) {
+            if (++failures <= 10) std::cerr << "MISMATCH on " << what << " at " << key << std::endl;
+        } else {
+            ++expected;
+        }
+        ++seen;
+    }, error);
+    if (!complete) {
+        ++failures;
+        std::cerr << what << " failed: " << error << std::endl;
+    }
+    if (seen != model.size()) {
+        ++failures;
+        std::cerr << what << " saw " << seen << " of " << model.size() << " records" << std::endl;
+    }
+    return failures;
+}
+
+int main(int argc, char** argv) {
+    size_t records = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    std::string dir = argc > 2 ? argv[2] : "lsm_bench.db";
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+
+    LSMStore store;
+    std::string error;
+    if (!store.open(dir, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    // Writes: every id once, then 20% overwritten and 10% deleted
+    std::mt19937 rng(42);
+    std::map<std::string, std::string> model;
+    uint64_t bytes = 0;
+    size_t writes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < records + records / 5 + records / 10; ++i) {
+        size_t id = i < records ? i + 1 : 1 + rng() % records;
+        std::string key = "FIR-" + std::to_string(id);
+        bool ok;
+        if (i >= records + records / 5) {
+            ok = store.remove(key, error);
+            model.erase(key);
+        } else {
+            std::string value = recordValue(id, rng);
+            bytes += key.size() + value.size();
+            ok = store.put(key, value, error);
+            model[key] = std::move(value);
+        }
+        if (!ok) {
+            std::cerr << "write failed: " << error << std::endl;
+            return 1;
+        }
+        ++writes;
+    }
+    double seconds = secondsSince(start);
+    std::cout << "Writes: " << writes << " in " << seconds << " s (" << writes / seconds << "/s, "
+              << bytes / seconds / (1024 * 1024) << " MiB/s)" << std::endl;
+    if (!store.flushNow(error) || !store.waitIdle(error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    LSMStore::Stats stats = store.stats();
+    printLevels(stats);
+
+    // Point lookups, present and absent keys alike
+    int failures = 0;
+    const size_t lookups = 100000;
+    uint64_t readsBefore = stats.blockReads;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; ++i) {
+        std::string key = "FIR-" + std::to_string(1 + rng() % (records + records / 10));
+        std::string value;
+        error.clear();
+        bool found = store.get(key, value, error);
+        auto it = model.find(key);
+        if (!error.empty() || found != (it != model.end()) || (found && value != it->second)) {
+            if (++failures <= 10) std::cerr << "MISMATCH on get " << key << std::endl;
+        }
+    }
+    seconds = secondsSince(start);
+    uint64_t blockReads = store.stats().blockReads - readsBefore;
+    std::cout << "Lookups: " << lookups << ", " << seconds * 1e6 / lookups << " us each, "
+              << static_cast<double>(blockReads) / lookups << " block reads each" << std::endl;
+
+    // Snapshot: later writes, a flush and the compactions it triggers
+    // must not show through
+    LSMStore::Snapshot view;
+    std::map<std::string, std::string> pinned;
+    double snapshotSeconds = 0;
+    for (size_t i = 0; i < records / 5; ++i) {
+        if (i == records / 10) { // memtable half full
+            start = std::chrono::steady_clock::now();
+            if (!store.snapshot(view, error)) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            snapshotSeconds = secondsSince(start);
+            pinned = model;
+        }
+        std::string key = "FIR-" + std::to_string(1 + rng() % records);
+        std::string value = recordValue(i, rng);
+        store.put(key, value, error);
+        model[key] = value;
+    }
+    if (!store.flushNow(error) || !store.waitIdle(error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    start = std::chrono::steady_clock::now();
+    failures += verifyScan("snapshot", [&](auto&& visit, std::string& err) { return store.forEach(view, visit, err); }, pinned);
+    std::cout << "Snapshot: taken in " << snapshotSeconds * 1e6 << " us, scanned " << pinned.size()
+              << " records in " << secondsSince(start) << " s after " << records / 10 << " more writes" << std::endl;
+    view = LSMStore::Snapshot();
+
+    // Recovery: writes since the last flush come back from the log
+    for (size_t i = 0; i < 1000; ++i) {
+        std::string key = "FIR-" + std::to_string(1 + rng() % records);
+        std::string value = recordValue(i, rng);
+        store.put(key, value, error);
+        model[key] = value;
+    }
+    store.close();
+    start = std::chrono::steady_clock::now();
+    if (!store.open(dir, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    failures += verifyScan("scan", [&](auto&& visit, std::string& err) { return store.forEach(visit, err); }, model);
+    std::cout << "Reopen + full scan: " << model.size() << " records in " << secondsSince(start) << " s" << std::endl;
+    store.close();
+    std::filesystem::remove_all(dir, ec);
+
+    std::cout << (failures ? "FAILED: " + std::to_string(failures) + " mismatches" : "All records match")
+              << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,1266 @@
+#ifndef LSM_STORE_HPP
+#define LSM_STORE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+#include "block_codec.hpp"
+
+// Log-structured merge store: string keys, byte-string values, deletes.
+//
+// A write is appended to a log file (sequential I/O) and applied to a
+// sorted in-memory memtable. A full memtable is frozen and a background
+// thread writes it out as an immutable sorted table (SSTable): ~4 KB data
+// blocks, LZ-compressed, then a block index of last keys, a Bloom filter
+// over all keys and a fixed footer. A table keeps its index and filter in
+// memory, so probing it is a filter check plus at most one block read.
+//
+// Tables are arranged in levels. Level 0 holds freshly flushed tables,
+// whose key ranges may overlap. Each deeper level is one sorted run of
+// non-overlapping tables with ten times the byte budget of the level above.
+// Once level 0 has four tables they are merged into level 1; when a deeper
+// level outgrows its budget, one of its tables is merged into the next.
+// Merging keeps the newest version of each key and drops deletions once
+// nothing older can sit below them.
+//
+// A lookup checks the memtables, then level-0 tables newest first, then
+// at most one table per deeper level. The MANIFEST lists the live tables
+// and is replaced atomically after every flush and compaction; on open,
+// logs not yet covered by a flushed table are replayed.
+//
+// Writes are serialized internally. Reads run concurrently with writes and
+// with background work; tables stay open while any reader still holds
+// them, and files of merged-away tables are deleted afterwards.
+//
+// A snapshot is a point-in-time view for long scans. Taking one freezes
+// the active memtable (queued for flushing like a full one) and pins the
+// frozen memtables and the current table set. All of these are immutable,
+// so the scan needs no lock and writers carry on at full speed meanwhile.
+
+// Fixed-width and varint encodings, little endian, plus CRC-32
+struct LSMCoding {
+    static void putFixed32(std::string& out, uint32_t v) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>(v >> (8 * i)));
+    }
+
+    static void putFixed64(std::string& out, uint64_t v) {
+        for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>(v >> (8 * i)));
+    }
+
+    static void putVarint(std::string& out, uint64_t v) {
+        while (v >= 128) {
+            out.push_back(static_cast<char>(v | 128));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    }
+
+    static void putBytes(std::string& out, const std::string& bytes) {
+        putVarint(out, bytes.size());
+        out += bytes;
+    }
+
+    static uint32_t fixed32(const char* p) {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= uint32_t(static_cast<uint8_t>(p[i])) << (8 * i);
+        return v;
+    }
+
+    static uint64_t fixed64(const char* p) {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= uint64_t(static_cast<uint8_t>(p[i])) << (8 * i);
+        return v;
+    }
+
+    // Reads from [p, end), advancing p; false on truncation
+    static bool getVarint(const char*& p, const char* end, uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64 && p < end; shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(*p++);
+            v |= uint64_t(byte & 127) << shift;
+            if (!(byte & 128)) return true;
+        }
+        return false;
+    }
+
+    static bool getBytes(const char*& p, const char* end, std::string& bytes) {
+        uint64_t size;
+        if (!getVarint(p, end, size) || size > static_cast<uint64_t>(end - p)) return false;
+        bytes.assign(p, size);
+        p += size;
+        return true;
+    }
+
+    static uint32_t crc32(const char* data, size_t size) {
+        static const auto table = [] {
+            std::vector<uint32_t> t(256);
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+        uint32_t crc = 0xffffffffu;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xff] ^ (crc >> 8);
+        }
+        return crc ^ 0xffffffffu;
+    }
+};
+
+// Append-only file with a write buffer
+class AppendFile {
+private:
+    int fd = -1;
+    std::string buffer;
+    uint64_t written = 0;
+
+public:
+    AppendFile() = default;
+    AppendFile(const AppendFile&) = delete;
+    AppendFile& operator=(const AppendFile&) = delete;
+
+    ~AppendFile() {
+        close();
+    }
+
+    bool open(const std::string& path) {
+        close();
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        written = 0;
+        return fd >= 0;
+    }
+
+    void append(const std::string& bytes) {
+        buffer += bytes;
+        written += bytes.size();
+    }
+
+    bool flush() {
+        const char* p = buffer.data();
+        size_t left = buffer.size();
+        while (left > 0) {
+            ssize_t n = ::write(fd, p, left);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+        buffer.clear();
+        return true;
+    }
+
+    bool sync() {
+        return flush() && ::fdatasync(fd) == 0;
+    }
+
+    void close() {
+        if (fd < 0) return;
+        flush();
+        ::close(fd);
+        fd = -1;
+    }
+
+    // Bytes appended so far, flushed or not
+    uint64_t size() const {
+        return written;
+    }
+};
+
+// Bloom filter with double hashing; ~1% false positives at 10 bits per key
+class BloomFilter {
+private:
+    static uint64_t hash(const std::string& key) {
+        uint64_t h = 1469598103934665603ULL;
+        for (unsigned char ch : key) h = (h ^ ch) * 1099511628211ULL;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+public:
+    static constexpr size_t kBitsPerKey = 10;
+    static constexpr uint32_t kProbes = 7; // ~ln 2 * bits per key
+
+    // Bit array for a table's key hashes
+    static std::string build(const std::vector<uint64_t>& hashes) {
+        size_t bits = std::max<size_t>(64, hashes.size() * kBitsPerKey);
+        std::string filter((bits + 7) / 8, '\0');
+        bits = filter.size() * 8;
+        for (uint64_t h : hashes) {
+            uint64_t delta = (h >> 32) | 1;
+            for (uint32_t i = 0; i < kProbes; ++i, h += delta) {
+                filter[(h % bits) / 8] |= static_cast<char>(1 << (h % 8));
+            }
+        }
+        return filter;
+    }
+
+    static uint64_t keyHash(const std::string& key) {
+        return hash(key);
+    }
+
+    static bool mayContain(const std::string& filter, const std::string& key) {
+        if (filter.empty()) return true;
+        size_t bits = filter.size() * 8;
+        uint64_t h = hash(key);
+        uint64_t delta = (h >> 32) | 1;
+        for (uint32_t i = 0; i < kProbes; ++i, h += delta) {
+            if (!(filter[(h % bits) / 8] & (1 << (h % 8)))) return false;
+        }
+        return true;
+    }
+};
+
+// One entry as stored in memtables, logs and tables
+struct LSMEntry {
+    enum Type : uint8_t { Deletion = 0, Value = 1 };
+
+    Type type = Value;
+    std::string value;
+};
+
+// Immutable sorted table file.
+//
+// Layout: data blocks, index block, filter block, 36-byte footer.
+// A data block on disk is codec byte (0 raw, 1 LZ), raw size, payload and
+// a CRC of the three; raw contents are entries of key, type byte, value.
+// The index holds the smallest key, then per block its last key, offset
+// and size. The footer gives index and filter positions, the entry count
+// and a magic number.
+class SSTable {
+public:
+    static constexpr size_t kBlockSize = 4096;
+    static constexpr uint32_t kMagic = 0x4c534d31; // "LSM1"
+    static constexpr size_t kFooterSize = 36;
+
+    enum Lookup { Missing, Found, Deleted, Corrupt }; // Corrupt: unreadable block
+
+    struct BlockHandle {
+        std::string lastKey;
+        uint64_t offset;
+        uint32_t size;
+    };
+
+    // Streams sorted entries into a new table file
+    class Writer {
+    private:
+        AppendFile file;
+        std::string block;
+        std::string lastKey;
+        std::string smallest;
+        std::vector<BlockHandle> index;
+        std::vector<uint64_t> hashes;
+        uint64_t entries = 0;
+
+        void finishBlock() {
+            if (block.empty()) return;
+            std::string encoded(1, '\1');
+            LSMCoding::putFixed32(encoded, static_cast<uint32_t>(block.size()));
+            std::vector<uint8_t> packed;
+            LZBlock::compress(reinterpret_cast<const uint8_t*>(block.data()), block.size(), packed);
+            if (packed.size() < block.size()) {
+                encoded.append(reinterpret_cast<const char*>(packed.data()), packed.size());
+            } else {
+                encoded[0] = '\0';
+                encoded += block;
+            }
+            LSMCoding::putFixed32(encoded, LSMCoding::crc32(encoded.data(), encoded.size()));
+            index.push_back(BlockHandle{lastKey, file.size(), static_cast<uint32_t>(encoded.size())});
+            file.append(encoded);
+            block.clear();
+        }
+
+    public:
+        bool open(const std::string& path) {
+            return file.open(path);
+        }
+
+        // Keys must arrive in strictly increasing order
+        void add(const std::string& key, const LSMEntry& entry) {
+            if (!entries) smallest = key;
+            LSMCoding::putBytes(block, key);
+            block.push_back(static_cast<char>(entry.type));
+            LSMCoding::putBytes(block, entry.value);
+            lastKey = key;
+            hashes.push_back(BloomFilter::keyHash(key));
+            ++entries;
+            if (block.size() >= kBlockSize) finishBlock();
+        }
+
+        uint64_t estimatedSize() const {
+            return file.size() + block.size();
+        }
+
+        uint64_t entryCount() const {
+            return entries;
+        }
+
+        bool finish() {
+            finishBlock();
+            std::string indexBlock;
+            LSMCoding::putBytes(indexBlock, smallest);
+            LSMCoding::putVarint(indexBlock, index.size());
+            for (const auto& handle : index) {
+                LSMCoding::putBytes(indexBlock, handle.lastKey);
+                LSMCoding::putFixed64(indexBlock, handle.offset);
+                LSMCoding::putFixed32(indexBlock, handle.size);
+            }
+            std::string filter = BloomFilter::build(hashes);
+            uint64_t indexOffset = file.size();
+            file.append(indexBlock);
+            uint64_t filterOffset = file.size();
+            file.append(filter);
+
+            std::string footer;
+            LSMCoding::putFixed64(footer, indexOffset);
+            LSMCoding::putFixed32(footer, static_cast<uint32_t>(indexBlock.size()));
+            LSMCoding::putFixed64(footer, filterOffset);
+            LSMCoding::putFixed32(footer, static_cast<uint32_t>(filter.size()));
+            LSMCoding::putFixed64(footer, entries);
+            LSMCoding::putFixed32(footer, kMagic);
+            file.append(footer);
+            bool ok = file.sync();
+            file.close();
+            return ok;
+        }
+    };
+
+private:
+    int fd = -1;
+    std::string path;
+    uint64_t number;
+    uint64_t fileSize = 0;
+    uint64_t entries = 0;
+    std::string smallest;
+    std::vector<BlockHandle> index;
+    std::string filter;
+    std::atomic<bool> obsolete{false};
+    mutable std::atomic<uint64_t> blockReads{0};
+
+    bool readAt(uint64_t offset, size_t size, std::string& out) const {
+        out.resize(size);
+        size_t done = 0;
+        while (done < size) {
+            ssize_t n = ::pread(fd, &out[done], size - done, static_cast<off_t>(offset + done));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+public:
+    SSTable(std::string filePath, uint64_t fileNumber) : path(std::move(filePath)), number(fileNumber) {}
+
+    SSTable(const SSTable&) = delete;
+    SSTable& operator=(const SSTable&) = delete;
+
+    // Closes the file, and deletes it once merged away
+    ~SSTable() {
+        if (fd >= 0) ::close(fd);
+        if (obsolete) std::remove(path.c_str());
+    }
+
+    bool open(std::string& error) {
+        fd = ::open(path.c_str(), O_RDONLY);
+        off_t end = fd >= 0 ? ::lseek(fd, 0, SEEK_END) : -1;
+        std::string footer;
+        if (end < static_cast<off_t>(kFooterSize) || !readAt(end - kFooterSize, kFooterSize, footer) ||
+            LSMCoding::fixed32(footer.data() + 32) != kMagic) {
+            error = "bad table file " + path;
+            return false;
+        }
+        fileSize = static_cast<uint64_t>(end);
+        uint64_t indexOffset = LSMCoding::fixed64(footer.data());
+        uint32_t indexSize = LSMCoding::fixed32(footer.data() + 8);
+        uint64_t filterOffset = LSMCoding::fixed64(footer.data() + 12);
+        uint32_t filterSize = LSMCoding::fixed32(footer.data() + 20);
+        entries = LSMCoding::fixed64(footer.data() + 24);
+
+        std::string indexBlock;
+        if (!readAt(indexOffset, indexSize, indexBlock) || !readAt(filterOffset, filterSize, filter)) {
+            error = "cannot read index of " + path;
+            return false;
+        }
+        const char* p = indexBlock.data();
+        const char* end2 = p + indexBlock.size();
+        uint64_t count;
+        if (!LSMCoding::getBytes(p, end2, smallest) || !LSMCoding::getVarint(p, end2, count)) {
+            error = "corrupt index in " + path;
+            return false;
+        }
+        index.resize(count);
+        for (auto& handle : index) {
+            if (!LSMCoding::getBytes(p, end2, handle.lastKey) || end2 - p < 12) {
+                error = "corrupt index in " + path;
+                return false;
+            }
+            handle.offset = LSMCoding::fixed64(p);
+            handle.size = LSMCoding::fixed32(p + 8);
+            p += 12;
+        }
+        return true;
+    }
+
+    // Raw contents of block i; false on I/O error or a bad checksum
+    bool readBlock(size_t i, std::string& raw) const {
+        const BlockHandle& handle = index[i];
+        std::string encoded;
+        if (handle.size < 9 || !readAt(handle.offset, handle.size, encoded)) return false;
+        blockReads.fetch_add(1, std::memory_order_relaxed);
+        size_t body = encoded.size() - 4;
+        if (LSMCoding::crc32(encoded.data(), body) != LSMCoding::fixed32(encoded.data() + body)) return false;
+        uint32_t rawSize = LSMCoding::fixed32(encoded.data() + 1);
+        if (encoded[0] == '\0') {
+            raw.assign(encoded, 5, body - 5);
+            return raw.size() == rawSize;
+        }
+        raw.resize(rawSize);
+        return LZBlock::decompress(reinterpret_cast<const uint8_t*>(encoded.data() + 5), body - 5,
+                                   reinterpret_cast<uint8_t*>(&raw[0]), rawSize);
+    }
+
+    // Decode one entry from a raw block; false at the end or on corruption
+    static bool nextEntry(const char*& p, const char* end, std::string& key, LSMEntry& entry) {
+        if (p >= end || !LSMCoding::getBytes(p, end, key) || p >= end) return false;
+        entry.type = static_cast<LSMEntry::Type>(*p++);
+        return LSMCoding::getBytes(p, end, entry.value);
+    }
+
+    Lookup get(const std::string& key, std::string& value) const {
+        if (key < smallest || index.empty() || key > index.back().lastKey) return Missing;
+        if (!BloomFilter::mayContain(filter, key)) return Missing;
+        auto it = std::lower_bound(index.begin(), index.end(), key,
+                                   [](const BlockHandle& h, const std::string& k) { return h.lastKey < k; });
+        if (it == index.end()) return Missing;
+        std::string raw;
+        if (!readBlock(static_cast<size_t>(it - index.begin()), raw)) return Corrupt;
+        const char* p = raw.data();
+        const char* end = p + raw.size();
+        std::string entryKey;
+        LSMEntry entry;
+        while (p < end) {
+            if (!nextEntry(p, end, entryKey, entry)) return Corrupt;
+            if (entryKey == key) {
+                if (entry.type == LSMEntry::Deletion) return Deleted;
+                value = std::move(entry.value);
+                return Found;
+            }
+            if (entryKey > key) break;
+        }
+        return Missing;
+    }
+
+    // Delete the file when the last reference goes
+    void markObsolete() {
+        obsolete = true;
+    }
+
+    uint64_t fileNumber() const { return number; }
+    const std::string& filePath() const { return path; }
+    uint64_t bytes() const { return fileSize; }
+    uint64_t entryCount() const { return entries; }
+    size_t blockCount() const { return index.size(); }
+    uint64_t reads() const { return blockReads.load(std::memory_order_relaxed); }
+    const std::string& smallestKey() const { return smallest; }
+    const std::string& largestKey() const { return index.back().lastKey; }
+
+    bool overlaps(const std::string& low, const std::string& high) const {
+        return !index.empty() && !(largestKey() < low || high < smallest);
+    }
+};
+
+struct LSMOptions {
+    size_t memtableBytes = 4 << 20; // freeze and flush past this
+    size_t tableBytes = 2 << 20;    // target size of compaction outputs
+    size_t level1Bytes = 10 << 20;  // each deeper level is 10x larger
+    size_t level0Tables = 4;        // merge level 0 into level 1 at this count
+    bool syncWrites = false;        // fdatasync the log on every write
+};
+
+class LSMStore {
+public:
+    using Options = LSMOptions;
+
+    struct Stats {
+        std::vector<size_t> tablesPerLevel;
+        std::vector<uint64_t> bytesPerLevel;
+        uint64_t flushes = 0;
+        uint64_t compactions = 0;
+        uint64_t bytesCompacted = 0;
+        uint64_t blockReads = 0;
+        size_t memtableBytes = 0;
+    };
+
+    static constexpr int kLevels = 7;
+
+private:
+    using Memtable = std::map<std::string, LSMEntry>;
+    using TablePtr = std::shared_ptr<SSTable>;
+
+    struct MemState {
+        std::shared_ptr<Memtable> table = std::make_shared<Memtable>();
+        size_t bytes = 0;
+        uint64_t firstLog = 0; // oldest log holding any of its entries
+    };
+
+    // Live tables; replaced wholesale, never edited, so readers can keep one
+    struct Version {
+        std::vector<TablePtr> levels[kLevels]; // level 0 newest first, others by key
+    };
+
+    Options options;
+    std::string dir;
+    bool opened = false;
+    bool fresh = false; // open() created the store
+
+    // Frozen memtable waiting to be flushed, with the first log it spans
+    struct Frozen {
+        std::shared_ptr<const Memtable> table;
+        uint64_t firstLog;
+    };
+
+    // Writers wait for a flush once this many frozen memtables are queued
+    static constexpr size_t kMaxFrozen = 2;
+
+public:
+    // Point-in-time view taken by snapshot(), read with forEach(). Holds
+    // only immutable state, so it may outlive later writes and compactions.
+    class Snapshot {
+    private:
+        friend class LSMStore;
+        std::vector<std::shared_ptr<const Memtable>> memtables; // newest first
+        std::shared_ptr<const Version> version;
+    };
+
+private:
+    MemState mem;
+    std::vector<Frozen> frozen; // oldest first
+    std::shared_ptr<const Version> version = std::make_shared<Version>();
+    AppendFile log;
+    uint64_t logNumber = 0;
+    uint64_t nextFile = 1;
+    std::string compactPointer[kLevels]; // round-robin start per level
+    Stats counters;
+    std::string backgroundError;
+
+    mutable std::mutex mutex;
+    std::condition_variable workReady;
+    std::condition_variable workDone;
+    std::thread worker;
+    bool stopping = false;
+
+    std::string fileName(uint64_t number, const char* suffix) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%06llu%s", static_cast<unsigned long long>(number), suffix);
+        return dir + "/" + name;
+    }
+
+    static uint64_t levelBudget(const Options& options, int level) {
+        uint64_t budget = options.level1Bytes;
+        for (int l = 1; l < level; ++l) budget *= 10;
+        return budget;
+    }
+
+    static uint64_t levelBytes(const Version& v, int level) {
+        uint64_t total = 0;
+        for (const auto& table : v.levels[level]) total += table->bytes();
+        return total;
+    }
+
+    static std::string logRecord(const std::string& key, const LSMEntry& entry) {
+        std::string payload(1, static_cast<char>(entry.type));
+        LSMCoding::putBytes(payload, key);
+        LSMCoding::putBytes(payload, entry.value);
+        std::string record;
+        LSMCoding::putFixed32(record, LSMCoding::crc32(payload.data(), payload.size()));
+        LSMCoding::putFixed32(record, static_cast<uint32_t>(payload.size()));
+        return record + payload;
+    }
+
+    // Apply a log file to the memtable; stops quietly at a torn tail
+    void replayLog(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const char* p = data.data();
+        const char* end = p + data.size();
+        while (end - p >= 8) {
+            uint32_t crc = LSMCoding::fixed32(p);
+            uint32_t size = LSMCoding::fixed32(p + 4);
+            if (!size || size > static_cast<uint64_t>(end - p - 8) || LSMCoding::crc32(p + 8, size) != crc) break;
+            const char* q = p + 9;
+            const char* recordEnd = p + 8 + size;
+            std::string key;
+            LSMEntry entry;
+            entry.type = static_cast<LSMEntry::Type>(p[8]);
+            if (!LSMCoding::getBytes(q, recordEnd, key) || !LSMCoding::getBytes(q, recordEnd, entry.value)) break;
+            mem.bytes += key.size() + entry.value.size() + 32;
+            (*mem.table)[key] = std::move(entry);
+            p = recordEnd;
+        }
+    }
+
+    // Replace MANIFEST: next file number, oldest live log, tables by level
+    bool writeManifest(const Version& v, uint64_t liveLog) {
+        std::ostringstream text;
+        text << "next " << nextFile << "\nlog " << liveLog << "\n";
+        for (int level = 0; level < kLevels; ++level) {
+            for (const auto& table : v.levels[level]) text << "table " << level << " " << table->fileNumber() << "\n";
+        }
+        std::string temp = dir + "/MANIFEST.tmp";
+        AppendFile file;
+        if (!file.open(temp)) return false;
+        file.append(text.str());
+        if (!file.sync()) return false;
+        file.close();
+        std::error_code ec;
+        std::filesystem::rename(temp, dir + "/MANIFEST", ec);
+        return !ec;
+    }
+
+    bool openLog(std::string& error) {
+        logNumber = nextFile++;
+        if (!log.open(fileName(logNumber, ".log"))) {
+            error = "cannot create log in " + dir;
+            return false;
+        }
+        return true;
+    }
+
+    // Drain next() (sorted entries) into tables of about tableBytes each,
+    // appended to out
+    template <typename Next>
+    bool writeTables(Next&& next, std::vector<TablePtr>& out, uint64_t& bytes, std::string& error) {
+        std::string key;
+        LSMEntry entry;
+        bool more = next(key, entry);
+        while (more) {
+            uint64_t number;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                number = nextFile++;
+            }
+            std::string path = fileName(number, ".sst");
+            SSTable::Writer writer;
+            if (!writer.open(path)) {
+                error = "cannot create " + path;
+                return false;
+            }
+            while (more && writer.estimatedSize() < options.tableBytes) {
+                writer.add(key, entry);
+                more = next(key, entry);
+            }
+            if (!writer.finish()) {
+                error = "cannot write " + path;
+                return false;
+            }
+            auto table = std::make_shared<SSTable>(path, number);
+            if (!table->open(error)) return false;
+            bytes += table->bytes();
+            out.push_back(table);
+        }
+        return true;
+    }
+
+    // Sequential reader over a sorted run of non-overlapping tables. A
+    // block that cannot be read or decoded ends the run with error set.
+    struct RunCursor {
+        std::vector<TablePtr> tables;
+        size_t table = 0;
+        size_t block = 0;
+        std::string raw;
+        const char* p = nullptr;
+        const char* end = nullptr;
+        std::string key;
+        LSMEntry entry;
+        bool valid = false;
+        std::string error;
+
+        explicit RunCursor(std::vector<TablePtr> run) : tables(std::move(run)) {
+            advance();
+        }
+
+        void advance() {
+            valid = false;
+            while (true) {
+                if (p < end) {
+                    if (!SSTable::nextEntry(p, end, key, entry)) break;
+                    valid = true;
+                    return;
+                }
+                while (table < tables.size() && block >= tables[table]->blockCount()) {
+                    ++table;
+                    block = 0;
+                }
+                if (table == tables.size()) return;
+                if (!tables[table]->readBlock(block++, raw)) break;
+                p = raw.data();
+                end = p + raw.size();
+            }
+            error = "damaged block " + std::to_string(block - 1) + " in " + tables[table]->filePath();
+        }
+    };
+
+    // K-way merge of memtables and table runs. Earlier sources are newer
+    // and win ties; each level-0 table is a run of its own, every deeper
+    // level a single run, so few cursors are ever compared.
+    class MergeCursor {
+    private:
+        struct MemCursor {
+            Memtable::const_iterator it, end;
+        };
+        std::vector<MemCursor> memtables;
+        std::vector<std::unique_ptr<RunCursor>> tables;
+
+        // Source with the smallest key; newest first on ties
+        size_t pick(const std::string*& key) const {
+            size_t best = SIZE_MAX;
+            key = nullptr;
+            for (size_t m = 0; m < memtables.size(); ++m) {
+                if (memtables[m].it == memtables[m].end) continue;
+                if (!key || memtables[m].it->first < *key) {
+                    key = &memtables[m].it->first;
+                    best = m;
+                }
+            }
+            for (size_t t = 0; t < tables.size(); ++t) {
+                if (!tables[t]->valid) continue;
+                if (!key || tables[t]->key < *key) {
+                    key = &tables[t]->key;
+                    best = memtables.size() + t;
+                }
+            }
+            return best;
+        }
+
+        void skip(const std::string& key) {
+            for (auto& cursor : memtables) {
+                if (cursor.it != cursor.end && cursor.it->first == key) ++cursor.it;
+            }
+            for (auto& cursor : tables) {
+                if (cursor->valid && cursor->key == key) cursor->advance();
+            }
+        }
+
+    public:
+        // newestFirst: memtables, newest first
+        MergeCursor(const std::vector<const Memtable*>& newestFirst, const std::vector<std::vector<TablePtr>>& runs) {
+            for (const Memtable* table : newestFirst) memtables.push_back(MemCursor{table->begin(), table->end()});
+            for (const auto& run : runs) {
+                if (!run.empty()) tables.emplace_back(new RunCursor(run));
+            }
+        }
+
+        // Newest version of the next key; false when all sources are done,
+        // or when one is damaged (see error())
+        bool next(std::string& key, LSMEntry& entry) {
+            if (!error().empty()) return false;
+            const std::string* smallest;
+            size_t source = pick(smallest);
+            if (source == SIZE_MAX) return false;
+            key = *smallest;
+            entry = source < memtables.size() ? memtables[source].it->second
+                                               : tables[source - memtables.size()]->entry;
+            skip(key);
+            return true;
+        }
+
+        // Why next() stopped early; empty if the sources were read in full
+        const std::string& error() const {
+            static const std::string none;
+            for (const auto& cursor : tables) {
+                if (!cursor->error.empty()) return cursor->error;
+            }
+            return none;
+        }
+    };
+
+    // Oldest log still needed to rebuild unflushed memtables
+    uint64_t liveLog() const {
+        return frozen.empty() ? mem.firstLog : frozen.front().firstLog;
+    }
+
+    // Oldest frozen memtable -> level-0 table, then forget its logs
+    bool flush(std::string& error) {
+        Frozen oldest;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            oldest = frozen.front();
+        }
+        MergeCursor cursor({oldest.table.get()}, {});
+        std::vector<TablePtr> written;
+        uint64_t bytes = 0;
+        if (!writeTables([&](std::string& k, LSMEntry& e) { return cursor.next(k, e); }, written, bytes, error)) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto next = std::make_shared<Version>(*version);
+        next->levels[0].insert(next->levels[0].begin(), written.rbegin(), written.rend());
+        frozen.erase(frozen.begin());
+        if (!writeManifest(*next, liveLog())) {
+            frozen.insert(frozen.begin(), oldest);
+            error = "cannot write MANIFEST";
+            return false;
+        }
+        for (uint64_t n = oldest.firstLog; n < liveLog(); ++n) std::remove(fileName(n, ".log").c_str());
+        version = next;
+        counters.flushes++;
+        return true;
+    }
+
+    // Next merge to run, if any level is over budget; inputs[0] is the
+    // upper level
+    bool pickCompaction(const Version& v, int& level, std::vector<TablePtr> inputs[2]) {
+        level = -1;
+        if (v.levels[0].size() >= options.level0Tables) {
+            level = 0;
+            inputs[0] = v.levels[0];
+        } else {
+            for (int l = 1; l < kLevels - 1 && level < 0; ++l) {
+                if (levelBytes(v, l) <= levelBudget(options, l)) continue;
+                level = l;
+                const auto& tables = v.levels[l];
+                auto it = std::find_if(tables.begin(), tables.end(), [&](const TablePtr& t) {
+                    return t->smallestKey() > compactPointer[l];
+                });
+                inputs[0].push_back(it != tables.end() ? *it : tables.front());
+                compactPointer[l] = inputs[0][0]->largestKey();
+            }
+        }
+        if (level < 0) return false;
+
+        std::string low = inputs[0][0]->smallestKey();
+        std::string high = inputs[0][0]->largestKey();
+        for (const auto& table : inputs[0]) {
+            low = std::min(low, table->smallestKey());
+            high = std::max(high, table->largestKey());
+        }
+        for (const auto& table : v.levels[level + 1]) {
+            if (table->overlaps(low, high)) inputs[1].push_back(table);
+        }
+        return true;
+    }
+
+    bool compact(std::string& error) {
+        std::shared_ptr<const Version> base;
+        int level;
+        std::vector<TablePtr> inputs[2];
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            base = version;
+            if (!pickCompaction(*base, level, inputs)) return false;
+        }
+
+        // Deletions can go once no deeper level may hold an older value
+        std::string low = inputs[0][0]->smallestKey(), high = inputs[0][0]->largestKey();
+        for (const auto& group : inputs) {
+            for (const auto& table : group) {
+                low = std::min(low, table->smallestKey());
+                high = std::max(high, table->largestKey());
+            }
+        }
+        bool bottom = true;
+        for (int l = level + 2; l < kLevels && bottom; ++l) {
+            for (const auto& table : base->levels[l]) bottom = bottom && !table->overlaps(low, high);
+        }
+
+        std::vector<std::vector<TablePtr>> runs;
+        if (level == 0) {
+            for (const auto& table : inputs[0]) runs.push_back({table});
+        } else {
+            runs.push_back(inputs[0]);
+        }
+        runs.push_back(inputs[1]);
+        MergeCursor cursor({}, runs);
+        auto next = [&](std::string& key, LSMEntry& entry) {
+            while (cursor.next(key, entry)) {
+                if (!(bottom && entry.type == LSMEntry::Deletion)) return true;
+            }
+            return false;
+        };
+        std::vector<TablePtr> written;
+        uint64_t bytes = 0;
+        if (!writeTables(next, written, bytes, error)) return false;
+        if (!cursor.error().empty()) {
+            // A truncated merge must not replace its inputs
+            error = cursor.error();
+            for (auto& table : written) table->markObsolete();
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto updated = std::make_shared<Version>(*version);
+        auto removeInputs = [](std::vector<TablePtr>& tables, const std::vector<TablePtr>& gone) {
+            tables.erase(std::remove_if(tables.begin(), tables.end(), [&](const TablePtr& t) {
+                return std::find(gone.begin(), gone.end(), t) != gone.end();
+            }), tables.end());
+        };
+        removeInputs(updated->levels[level], inputs[0]);
+        removeInputs(updated->levels[level + 1], inputs[1]);
+        auto& target = updated->levels[level + 1];
+        target.insert(target.end(), written.begin(), written.end());
+        std::sort(target.begin(), target.end(), [](const TablePtr& a, const TablePtr& b) {
+            return a->smallestKey() < b->smallestKey();
+        });
+        if (!writeManifest(*updated, liveLog())) {
+            error = "cannot write MANIFEST";
+            for (auto& table : written) table->markObsolete();
+            return false;
+        }
+        for (const auto& group : inputs) {
+            for (const auto& table : group) table->markObsolete();
+        }
+        version = updated;
+        counters.compactions++;
+        counters.bytesCompacted += bytes;
+        return true;
+    }
+
+    // Flushes first, then compactions, until stopped. After an I/O error
+    // it does nothing more; writers see the error once the memtable fills.
+    void backgroundLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            workReady.wait(lock, [this] {
+                return stopping || (backgroundError.empty() && (!frozen.empty() || needsCompaction()));
+            });
+            if (stopping) return;
+            bool flushing = !frozen.empty();
+            lock.unlock();
+            std::string error;
+            bool ok = flushing ? flush(error) : compact(error);
+            lock.lock();
+            if (!ok && !error.empty()) backgroundError = error;
+            workDone.notify_all();
+        }
+    }
+
+    bool needsCompaction() const {
+        if (version->levels[0].size() >= options.level0Tables) return true;
+        for (int l = 1; l < kLevels - 1; ++l) {
+            if (levelBytes(*version, l) > levelBudget(options, l)) return true;
+        }
+        return false;
+    }
+
+    // Queue the active memtable for flushing and start a new one with its
+    // own log. Caller holds the lock.
+    bool freeze(std::string& error) {
+        if (!backgroundError.empty()) {
+            error = backgroundError;
+            return false;
+        }
+        if (!log.sync()) {
+            error = "cannot sync log";
+            return false;
+        }
+        frozen.push_back(Frozen{mem.table, mem.firstLog});
+        mem = MemState();
+        if (!openLog(error)) return false;
+        mem.firstLog = logNumber;
+        workReady.notify_one();
+        return true;
+    }
+
+    // Freeze the memtable once full, first waiting while kMaxFrozen are
+    // still being flushed. Caller holds the lock.
+    bool makeRoom(std::unique_lock<std::mutex>& lock, std::string& error) {
+        if (mem.bytes < options.memtableBytes) return true;
+        workDone.wait(lock, [this] { return frozen.size() < kMaxFrozen || !backgroundError.empty(); });
+        return freeze(error);
+    }
+
+    bool write(const std::string& key, LSMEntry entry, std::string& error) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!opened) {
+            error = "store not open";
+            return false;
+        }
+        if (!makeRoom(lock, error)) return false;
+        log.append(logRecord(key, entry));
+        if (!(options.syncWrites ? log.sync() : log.flush())) {
+            error = "cannot append to log";
+            return false;
+        }
+        mem.bytes += key.size() + entry.value.size() + 32;
+        (*mem.table)[key] = std::move(entry);
+        return true;
+    }
+
+public:
+    LSMStore() = default;
+    LSMStore(const LSMStore&) = delete;
+    LSMStore& operator=(const LSMStore&) = delete;
+
+    ~LSMStore() {
+        close();
+    }
+
+    // Open or create the store in directory path and replay its logs
+    bool open(const std::string& path, std::string& error, const Options& opts = Options()) {
+        close();
+        options = opts;
+        dir = path;
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        if (ec) {
+            error = "cannot create " + dir + ": " + ec.message();
+            return false;
+        }
+
+        auto loaded = std::make_shared<Version>();
+        uint64_t liveLog = 0;
+        std::ifstream manifest(dir + "/MANIFEST");
+        bool hasManifest = static_cast<bool>(manifest);
+        std::string word;
+        while (manifest >> word) {
+            if (word == "next") {
+                manifest >> nextFile;
+            } else if (word == "log") {
+                manifest >> liveLog;
+            } else if (word == "table") {
+                int level;
+                uint64_t number;
+                manifest >> level >> number;
+                if (level < 0 || level >= kLevels) {
+                    error = "corrupt MANIFEST in " + dir;
+                    return false;
+                }
+                auto table = std::make_shared<SSTable>(fileName(number, ".sst"), number);
+                if (!table->open(error)) return false;
+                loaded->levels[level].push_back(table);
+            }
+        }
+        auto& level0 = loaded->levels[0];
+        std::sort(level0.begin(), level0.end(), [](const TablePtr& a, const TablePtr& b) {
+            return a->fileNumber() > b->fileNumber();
+        });
+        for (int l = 1; l < kLevels; ++l) {
+            std::sort(loaded->levels[l].begin(), loaded->levels[l].end(), [](const TablePtr& a, const TablePtr& b) {
+                return a->smallestKey() < b->smallestKey();
+            });
+        }
+        version = loaded;
+
+        // Logs at or after liveLog hold writes no table has yet; tables the
+        // MANIFEST does not list are leftovers of an interrupted compaction
+        std::vector<uint64_t> logs;
+        std::vector<uint64_t> live;
+        for (const auto& level : loaded->levels) {
+            for (const auto& table : level) live.push_back(table->fileNumber());
+        }
+        for (const auto& file : std::filesystem::directory_iterator(dir, ec)) {
+            std::string name = file.path().filename().string();
+            bool isLog = name.size() == 10 && name.compare(6, 4, ".log") == 0;
+            bool isTable = name.size() == 10 && name.compare(6, 4, ".sst") == 0;
+            if (!isLog && !isTable) continue;
+            uint64_t number = std::stoull(name.substr(0, 6));
+            nextFile = std::max(nextFile, number + 1);
+            if (isLog && number >= liveLog) logs.push_back(number);
+            if (isLog && number < liveLog) std::remove(file.path().c_str());
+            if (isTable && std::find(live.begin(), live.end(), number) == live.end()) {
+                std::remove(file.path().c_str());
+            }
+        }
+        std::sort(logs.begin(), logs.end());
+        mem = MemState();
+        for (uint64_t number : logs) replayLog(fileName(number, ".log"));
+        mem.firstLog = logs.empty() ? nextFile : logs.front();
+        if (!openLog(error)) return false;
+        if (logs.empty()) mem.firstLog = logNumber;
+        // A MANIFEST from the start marks the store as existing, so that
+        // created() stays false after every key is removed
+        fresh = !hasManifest && logs.empty();
+        if (!hasManifest && !writeManifest(*loaded, mem.firstLog)) {
+            error = "cannot write MANIFEST in " + dir;
+            return false;
+        }
+
+        counters = Stats();
+        backgroundError.clear();
+        stopping = false;
+        opened = true;
+        worker = std::thread([this] { backgroundLoop(); });
+        return true;
+    }
+
+    // Whether the last open() created the store rather than finding one,
+    // even one whose keys have all been removed since
+    bool created() const {
+        return fresh;
+    }
+
+    // Stop background work; unflushed writes stay in the log
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!opened) return;
+            stopping = true;
+            opened = false;
+        }
+        workReady.notify_all();
+        worker.join();
+        log.close();
+        frozen.clear();
+        mem = MemState();
+        version = std::make_shared<Version>();
+    }
+
+    bool put(const std::string& key, const std::string& value, std::string& error) {
+        return write(key, LSMEntry{LSMEntry::Value, value}, error);
+    }
+
+    bool remove(const std::string& key, std::string& error) {
+        return write(key, LSMEntry{LSMEntry::Deletion, ""}, error);
+    }
+
+    // False if key is absent or deleted, or with error set if a table
+    // holding it is damaged
+    bool get(const std::string& key, std::string& value, std::string& error) const {
+        std::vector<Frozen> queued;
+        std::shared_ptr<const Version> current;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = mem.table->find(key);
+            if (it != mem.table->end()) {
+                if (it->second.type == LSMEntry::Deletion) return false;
+                value = it->second.value;
+                return true;
+            }
+            queued = frozen;
+            current = version;
+        }
+        for (auto m = queued.rbegin(); m != queued.rend(); ++m) {
+            auto it = m->table->find(key);
+            if (it != m->table->end()) {
+                if (it->second.type == LSMEntry::Deletion) return false;
+                value = it->second.value;
+                return true;
+            }
+        }
+        auto settle = [&](const TablePtr& table, SSTable::Lookup found) {
+            if (found == SSTable::Corrupt) error = "damaged block in " + table->filePath();
+            return found == SSTable::Found;
+        };
+        for (int level = 0; level < kLevels; ++level) {
+            const auto& tables = current->levels[level];
+            if (level == 0) {
+                for (const auto& table : tables) {
+                    SSTable::Lookup found = table->get(key, value);
+                    if (found != SSTable::Missing) return settle(table, found);
+                }
+                continue;
+            }
+            // One candidate per sorted level: the first table ending at or after key
+            auto it = std::lower_bound(tables.begin(), tables.end(), key, [](const TablePtr& t, const std::string& k) {
+                return t->largestKey() < k;
+            });
+            if (it == tables.end()) continue;
+            SSTable::Lookup found = (*it)->get(key, value);
+            if (found != SSTable::Missing) return settle(*it, found);
+        }
+        return false;
+    }
+
+    // Pin the current state of the store for forEach(). Costs a memtable
+    // freeze, not a copy of any data: a new log file, plus an fdatasync
+    // of the old one unless syncWrites already keeps it synced.
+    bool snapshot(Snapshot& view, std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!opened) {
+            error = "store not open";
+            return false;
+        }
+        if (!mem.table->empty() && !freeze(error)) return false;
+        view.memtables.clear();
+        for (auto m = frozen.rbegin(); m != frozen.rend(); ++m) view.memtables.push_back(m->table);
+        view.version = version;
+        return true;
+    }
+
+    // Visit every live key of a snapshot in order with its value, without
+    // holding any lock. False, with error, if a damaged table cut the scan
+    // short; keys before the damage were visited.
+    template <typename F>
+    bool forEach(const Snapshot& view, F visit, std::string& error) const {
+        std::vector<const Memtable*> memtables;
+        for (const auto& table : view.memtables) memtables.push_back(table.get());
+        std::vector<std::vector<TablePtr>> runs;
+        if (view.version) {
+            for (const auto& table : view.version->levels[0]) runs.push_back({table});
+            for (int level = 1; level < kLevels; ++level) runs.push_back(view.version->levels[level]);
+        }
+        MergeCursor cursor(memtables, runs);
+        std::string key;
+        LSMEntry entry;
+        while (cursor.next(key, entry)) {
+            if (entry.type == LSMEntry::Value) visit(key, entry.value);
+        }
+        error = cursor.error();
+        return error.empty();
+    }
+
+    // Visit every live key in order with its value. Works on a copy of
+    // the active memtable, so writers are only held up for that copy.
+    template <typename F>
+    bool forEach(F visit, std::string& error) const {
+        Snapshot view;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            view.memtables.push_back(std::make_shared<const Memtable>(*mem.table));
+            for (auto m = frozen.rbegin(); m != frozen.rend(); ++m) view.memtables.push_back(m->table);
+            view.version = version;
+        }
+        return forEach(view, visit, error);
+    }
+
+    // Block until no flush or compaction is pending
+    bool waitIdle(std::string& error) {
+        std::unique_lock<std::mutex> lock(mutex);
+        workReady.notify_one();
+        workDone.wait(lock, [this] { return (frozen.empty() && !needsCompaction()) || !backgroundError.empty(); });
+        error = backgroundError;
+        return error.empty();
+    }
+
+    // Freeze the memtable now, whatever its size
+    bool flushNow(std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (mem.table->empty()) return true;
+        return freeze(error);
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stats result = counters;
+        result.memtableBytes = mem.bytes;
+        for (int level = 0; level < kLevels; ++level) {
+            result.tablesPerLevel.push_back(version->levels[level].size());
+            result.bytesPerLevel.push_back(levelBytes(*version, level));
+            for (const auto& table : version->levels[level]) result.blockReads += table->reads();
+        }
+        return result;
+    }
+};
+
+#endif // LSM_STORE_HPP
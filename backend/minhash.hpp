@@ -0,0 +1,202 @@
+#ifndef MINHASH_HPP
+#define MINHASH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Near-duplicate detection for incident descriptions.
+//
+// Each text becomes a set of character 5-grams (after lowercasing and
+// collapsing punctuation/whitespace), summarized by a 128-value MinHash
+// signature. Signatures are split into 32 bands of 4 rows; two texts
+// become candidates when any band hashes equal, which happens with high
+// probability once their Jaccard similarity passes ~0.45. Candidates are
+// then scored by signature agreement, so lookups only touch the few
+// documents sharing a band instead of the whole collection.
+class MinHashIndex {
+public:
+    static constexpr size_t kHashes = 128;
+    static constexpr size_t kBands = 32;
+    static constexpr size_t kRows = kHashes / kBands;
+    static constexpr size_t kShingle = 5;
+
+    using Signature = std::array<uint32_t, kHashes>;
+
+    struct Match {
+        std::string id;
+        double similarity; // estimated Jaccard
+    };
+
+private:
+    struct Document {
+        std::string id;
+        Signature signature;
+        bool live;
+    };
+
+    std::vector<Document> documents;
+    std::vector<uint32_t> freeSlots; // dead documents, reused by add()
+    std::unordered_map<std::string, uint32_t> slotOf;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> bands[kBands];
+    double threshold;
+
+    static uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Odd multipliers / offsets for the kHashes hash functions
+    static const std::array<std::pair<uint64_t, uint64_t>, kHashes>& coefficients() {
+        static const auto table = [] {
+            std::array<std::pair<uint64_t, uint64_t>, kHashes> t{};
+            uint64_t state = 0x9e3779b97f4a7c15ULL;
+            for (auto& entry : t) {
+                state = mix(state + 0x9e3779b97f4a7c15ULL);
+                entry.first = state | 1;
+                state = mix(state + 0x9e3779b97f4a7c15ULL);
+                entry.second = state;
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    static std::string normalize(const std::string& text) {
+        std::string out;
+        out.reserve(text.size());
+        for (unsigned char ch : text) {
+            if (std::isalnum(ch)) {
+                out.push_back(static_cast<char>(std::tolower(ch)));
+            } else if (!out.empty() && out.back() != ' ') {
+                out.push_back(' ');
+            }
+        }
+        if (!out.empty() && out.back() == ' ') out.pop_back();
+        return out;
+    }
+
+    static uint64_t bandKey(const Signature& signature, size_t band) {
+        uint64_t h = band;
+        for (size_t r = 0; r < kRows; ++r) {
+            h = mix(h ^ signature[band * kRows + r]) + r;
+        }
+        return h;
+    }
+
+    static double agreement(const Signature& a, const Signature& b) {
+        size_t same = 0;
+        for (size_t i = 0; i < kHashes; ++i) same += a[i] == b[i];
+        return static_cast<double>(same) / kHashes;
+    }
+
+    std::vector<Match> candidates(const Signature& signature, uint32_t self) const {
+        std::vector<uint32_t> seen;
+        for (size_t band = 0; band < kBands; ++band) {
+            auto it = bands[band].find(bandKey(signature, band));
+            if (it == bands[band].end()) continue;
+            seen.insert(seen.end(), it->second.begin(), it->second.end());
+        }
+        std::sort(seen.begin(), seen.end());
+        seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+
+        std::vector<Match> matches;
+        for (uint32_t slot : seen) {
+            const Document& doc = documents[slot];
+            if (slot == self || !doc.live) continue;
+            double similarity = agreement(signature, doc.signature);
+            if (similarity >= threshold) matches.push_back(Match{doc.id, similarity});
+        }
+        std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+            return a.similarity > b.similarity;
+        });
+        return matches;
+    }
+
+public:
+    explicit MinHashIndex(double minSimilarity = 0.6) : threshold(minSimilarity) {}
+
+    // False if the text is too short to shingle
+    static bool sign(const std::string& text, Signature& signature) {
+        std::string norm = normalize(text);
+        if (norm.empty()) return false;
+        signature.fill(UINT32_MAX);
+        const auto& coeff = coefficients();
+        size_t span = std::min(kShingle, norm.size());
+        for (size_t i = 0; i + span <= norm.size(); ++i) {
+            uint64_t h = 1469598103934665603ULL;
+            for (size_t k = 0; k < span; ++k) {
+                h = (h ^ static_cast<unsigned char>(norm[i + k])) * 1099511628211ULL;
+            }
+            h = mix(h);
+            for (size_t j = 0; j < kHashes; ++j) {
+                uint32_t v = static_cast<uint32_t>((coeff[j].first * h + coeff[j].second) >> 32);
+                signature[j] = std::min(signature[j], v);
+            }
+        }
+        return true;
+    }
+
+    // Index text under id and return earlier documents that look like it
+    std::vector<Match> add(const std::string& id, const std::string& text) {
+        remove(id);
+        Signature signature;
+        if (!sign(text, signature)) return {};
+
+        uint32_t slot = static_cast<uint32_t>(documents.size());
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        std::vector<Match> matches = candidates(signature, slot);
+        if (slot == documents.size()) {
+            documents.push_back(Document{id, signature, true});
+        } else {
+            documents[slot] = Document{id, signature, true};
+        }
+        slotOf[id] = slot;
+        for (size_t band = 0; band < kBands; ++band) {
+            bands[band][bandKey(signature, band)].push_back(slot);
+        }
+        return matches;
+    }
+
+    void remove(const std::string& id) {
+        auto it = slotOf.find(id);
+        if (it == slotOf.end()) return;
+        Document& doc = documents[it->second];
+        for (size_t band = 0; band < kBands; ++band) {
+            auto bucket = bands[band].find(bandKey(doc.signature, band));
+            if (bucket == bands[band].end()) continue;
+            auto& list = bucket->second;
+            list.erase(std::remove(list.begin(), list.end(), it->second), list.end());
+            if (list.empty()) bands[band].erase(bucket);
+        }
+        // No band lists the slot any more, so it can be handed out again
+        doc.live = false;
+        std::string().swap(doc.id);
+        freeSlots.push_back(it->second);
+        slotOf.erase(it);
+    }
+
+    std::vector<Match> duplicatesOf(const std::string& id) const {
+        auto it = slotOf.find(id);
+        if (it == slotOf.end()) return {};
+        return candidates(documents[it->second].signature, it->second);
+    }
+
+    bool contains(const std::string& id) const {
+        return slotOf.count(id) > 0;
+    }
+};
+
+#endif // MINHASH_HPP
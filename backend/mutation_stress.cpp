@@ -0,0 +1,288 @@
+/**
+ * FIRStore mutation stress test
+ * Writers create, replace, patch, re-status and delete records while
+ * readers query, search and walk the case graph, all under the store's
+ * read/write locks the way the HTTP handlers use them. Afterwards every
+ * secondary index is checked against a brute-force scan of the records
+ * and against a model the writers kept of what should be stored.
+ *
+ * Compile: g++ -std=c++17 -O2 mutation_stress.cpp -o mutation_stress -ljsoncpp -lpthread
+ * Run: ./mutation_stress [seconds] [writers] [readers]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+#include "fir_store.hpp"
+
+static const char* kStatuses[] = {"open", "closed", "under_investigation"};
+static const char* kDistricts[] = {"Pune", "Mumbai", "Nagpur", "Nashik"};
+static const char* kStations[] = {"Central", "North", "South"};
+static const char* kNames[] = {"Asha Rao", "Arjun Mehta", "Bilal Khan", "Bina Das", "Chetan Patil"};
+static const char* kWords[] = {"theft", "phone", "bike", "assault", "market", "night", "fraud"};
+static const int kIdSpace = 2000;
+
+static FIRRecord randomRecord(int id, std::mt19937& rng) {
+    auto pick = [&rng](int n) { return static_cast<int>(rng() % n); };
+    FIRRecord record;
+    record.id = id;
+    record.complainant = kNames[pick(5)];
+    record.suspect = kNames[pick(5)];
+    record.date = "2025-" + std::to_string(1 + pick(12)) + "-1" + std::to_string(pick(10));
+    if (record.date.size() == 9) record.date.insert(5, "0");
+    record.location = kStations[pick(3)];
+    record.description = std::string(kWords[pick(7)]) + " " + kWords[pick(7)];
+    record.status = kStatuses[pick(3)];
+    // Rare one-off districts free their dictionary codes for reuse
+    record.district = pick(8) ? kDistricts[pick(4)] : "Ward " + std::to_string(pick(200));
+    record.policeStation = kStations[pick(3)];
+    record.suspectPhone = pick(4) == 0 ? "98765" + std::to_string(10000 + pick(50)) : "";
+    record.ipcSections.push_back(pick(2) ? "379" : "420");
+    if (pick(3) == 0) record.relatedIds.push_back(1 + pick(kIdSpace));
+    return record;
+}
+
+static std::vector<int> sortedIds(const std::vector<FIRRecord*>& records) {
+    std::vector<int> ids;
+    for (const FIRRecord* record : records) ids.push_back(record->id);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok) {
+        ++failures;
+        if (failures <= 20) std::cerr << "MISMATCH: " << what << std::endl;
+    }
+}
+
+// Indexed answers must equal a scan of the stored records
+static void checkConsistency(FIRStore& store, const std::map<int, std::string>& model,
+                             const std::set<int>& deleted) {
+    std::vector<FIRRecord*> all = store.all();
+    expect(all.size() == model.size(), "record count " + std::to_string(all.size()) +
+                                           " vs model " + std::to_string(model.size()));
+    for (const auto& [id, status] : model) {
+        FIRRecord* record = store.getById(id);
+        expect(record && record->status.str() == status, "record " + std::to_string(id));
+    }
+    for (int id : deleted) {
+        expect(!store.getById(id), "deleted record " + std::to_string(id) + " still stored");
+    }
+    expect(store.analytics().liveCount() == all.size(), "column live count");
+
+    auto scan = [&all](auto&& keep) {
+        std::vector<int> ids;
+        for (const FIRRecord* record : all) {
+            if (keep(*record)) ids.push_back(record->id);
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    };
+    auto query = [&store](const std::string& text) {
+        Json::Value json;
+        Json::Reader().parse(text, json);
+        Predicate predicate;
+        std::string error;
+        Predicate::parse(json, predicate, error);
+        std::vector<std::string> plan;
+        return sortedIds(store.query(predicate, plan));
+    };
+
+    const StatsCube& cube = store.statsCube();
+    uint64_t cubeTotal = 0;
+    for (const auto& cell : cube.cuboid(0)) cubeTotal += cell.second;
+    expect(cubeTotal == all.size(), "cube total");
+
+    for (const char* status : kStatuses) {
+        auto expected = scan([&](const FIRRecord& r) { return r.status.str() == status; });
+        expect(query(std::string("{\"field\":\"status\",\"eq\":\"") + status + "\"}") == expected,
+               std::string("status index ") + status);
+        StatsCube::Key key{InternedString(status).code(), StatsCube::kAll, StatsCube::kAll, StatsCube::kAll};
+        auto cell = cube.cuboid(1u << StatsCube::Status).find(key);
+        uint64_t counted = cell == cube.cuboid(1u << StatsCube::Status).end() ? 0 : cell->second;
+        expect(counted == expected.size(), std::string("cube status ") + status);
+        expect(sortedIds(store.listByStatus(status)) == expected, std::string("status column ") + status);
+        // A NOT cannot use an index, so this scans the columns
+        expect(query(std::string("{\"not\":{\"field\":\"status\",\"eq\":\"") + status + "\"}}") ==
+                   scan([&](const FIRRecord& r) { return r.status.str() != status; }),
+               std::string("status column scan ") + status);
+    }
+    std::map<std::string, uint64_t> byDistrict;
+    for (const FIRRecord* record : all) byDistrict[record->district]++;
+    const StatsCube::Cuboid& districtCells = cube.cuboid(1u << StatsCube::District);
+    expect(districtCells.size() == byDistrict.size(), "cube district cells");
+    for (const auto& cell : districtCells) {
+        auto it = byDistrict.find(cube.label(StatsCube::District, cell.first[StatsCube::District]));
+        expect(it != byDistrict.end() && it->second == cell.second, "cube district label");
+    }
+    for (const char* district : {"Pune", "Mumbai", "Ward 7", "Ward 150"}) {
+        auto expected = scan([&](const FIRRecord& r) { return r.district == district; });
+        expect(query(std::string("{\"field\":\"district\",\"eq\":\"") + district + "\"}") == expected,
+               std::string("district index ") + district);
+    }
+    for (const char* station : kStations) {
+        auto expected = scan([&](const FIRRecord& r) { return r.policeStation == station; });
+        expect(query(std::string("{\"field\":\"policeStation\",\"eq\":\"") + station + "\"}") == expected,
+               std::string("station index ") + station);
+        expected = scan([&](const FIRRecord& r) { return r.location == station; });
+        expect(query(std::string("{\"field\":\"location\",\"eq\":\"") + station + "\"}") == expected,
+               std::string("location index ") + station);
+    }
+    for (const char* word : kWords) {
+        auto expected = scan([&](const FIRRecord& r) {
+            auto words = TextIndex::words(r.description);
+            return std::find(words.begin(), words.end(), word) != words.end();
+        });
+        expect(query(std::string("{\"field\":\"description\",\"contains\":\"") + word + "\"}") == expected,
+               std::string("description index ") + word);
+    }
+    expect(query("{\"field\":\"date\",\"from\":\"2025-03-01\",\"to\":\"2025-06-30\"}") ==
+               scan([](const FIRRecord& r) { return r.date >= "2025-03-01" && r.date <= "2025-06-30"; }),
+           "date index");
+    for (const char* prefix : {"a", "ar", "bina", "chetan p"}) {
+        auto lower = [](std::string text) {
+            std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+            return text;
+        };
+        expect(sortedIds(store.searchComplainant(prefix)) ==
+                   scan([&](const FIRRecord& r) { return lower(r.complainant).rfind(prefix, 0) == 0; }),
+               std::string("complainant trie ") + prefix);
+        expect(sortedIds(store.searchSuspect(prefix)) ==
+                   scan([&](const FIRRecord& r) { return lower(r.suspect).rfind(prefix, 0) == 0; }),
+               std::string("suspect trie ") + prefix);
+        expect(query(std::string("{\"field\":\"suspect\",\"prefix\":\"") + prefix + "\"}") ==
+                   scan([&](const FIRRecord& r) { return lower(r.suspect).rfind(prefix, 0) == 0; }),
+               std::string("suspect prefix query ") + prefix);
+    }
+    {
+        Json::Value json;
+        Json::Reader().parse("{\"field\":\"complainant\",\"prefix\":\"\"}", json);
+        Predicate predicate;
+        std::string error;
+        expect(!Predicate::parse(json, predicate, error), "empty prefix rejected");
+    }
+
+    // Graph: explicit links present and in one cluster; deleted records,
+    // listed or not, are in neither
+    UnionFind& clusters = store.caseClusters();
+    for (const FIRRecord* record : all) {
+        std::vector<int> neighbors;
+        for (const FIRRecord* other : store.related(record->id)) neighbors.push_back(other->id);
+        for (int relId : record->relatedIds) {
+            if (!store.getById(relId) || relId == record->id) continue;
+            expect(std::find(neighbors.begin(), neighbors.end(), relId) != neighbors.end(),
+                   "edge " + std::to_string(record->id) + "-" + std::to_string(relId));
+            expect(clusters.clusterOf(record->id) == clusters.clusterOf(relId),
+                   "cluster " + std::to_string(record->id) + "-" + std::to_string(relId));
+        }
+    }
+    for (int id : deleted) {
+        expect(store.relatedWithin(id, 1, 10).vertices.empty() && !clusters.contains(id),
+               "deleted record " + std::to_string(id) + " still linked");
+    }
+}
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? std::atof(argv[1]) : 3.0;
+    int writers = argc > 2 ? std::atoi(argv[2]) : 4;
+    int readers = argc > 3 ? std::atoi(argv[3]) : 4;
+
+    FIRStore store;
+    std::map<int, std::string> model; // id -> expected status, guarded by the store's write lock
+    std::set<int> deleted;
+    std::atomic<bool> stop{false};
+    std::atomic<long> writes{0}, reads{0};
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            std::mt19937 rng(1000 + w);
+            while (!stop.load(std::memory_order_relaxed)) {
+                int id = 1 + static_cast<int>(rng() % kIdSpace);
+                FIRRecord next = randomRecord(id, rng);
+                int op = static_cast<int>(rng() % 10);
+
+                auto lock = store.writeLock();
+                bool exists = model.count(id) > 0;
+                if (!exists || op < 3) {
+                    FIRRecord* record = store.add(std::move(next)).record;
+                    model[id] = record->status.str();
+                    deleted.erase(id);
+                } else if (op < 5) {
+                    model[id] = store.update(id, std::move(next))->status.str();
+                } else if (op < 7) {
+                    FIRRecord* record = store.patch(id, [&](FIRRecord& r) {
+                        r.description = next.description;
+                        r.suspect = next.suspect;
+                        r.relatedIds = next.relatedIds;
+                    });
+                    model[id] = record->status.str();
+                } else if (op < 8) {
+                    model[id] = store.setStatus(id, next.status)->status.str();
+                } else {
+                    store.remove(id);
+                    model.erase(id);
+                    deleted.insert(id);
+                }
+                writes.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            std::mt19937 rng(2000 + r);
+            Json::Value where;
+            where["field"] = "status";
+            where["eq"] = "open";
+            Predicate predicate;
+            std::string error;
+            Predicate::parse(where, predicate, error);
+            while (!stop.load(std::memory_order_relaxed)) {
+                int id = 1 + static_cast<int>(rng() % kIdSpace);
+                auto lock = store.readLock();
+                size_t touched = 0;
+                switch (rng() % 4) {
+                case 0: {
+                    std::vector<std::string> plan;
+                    for (FIRRecord* record : store.query(predicate, plan)) touched += record->description.size();
+                    break;
+                }
+                case 1:
+                    for (FIRRecord* record : store.searchComplainant(kNames[rng() % 5])) touched += record->id;
+                    break;
+                case 2:
+                    touched += store.relatedWithin(id, 2, 50).vertices.size();
+                    break;
+                default:
+                    if (FIRRecord* record = store.getById(id)) touched += record->toJson().size();
+                    touched += store.statsCube().cuboid(1u << StatsCube::District).size();
+                }
+                lock.unlock();
+                if (touched != SIZE_MAX) reads.fetch_add(1, std::memory_order_relaxed);
+                // Request handling time outside the lock; back-to-back
+                // readers would starve writers on a reader-preferring lock
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& thread : threads) thread.join();
+
+    checkConsistency(store, model, deleted);
+    std::cout << "Writes: " << writes << ", reads: " << reads << ", live records: "
+              << model.size() << ", deleted: " << deleted.size() << std::endl;
+    std::cout << (failures ? "FAILED: " + std::to_string(failures) + " mismatches" : "All indexes consistent")
+              << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,119 @@
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Slab allocator that owns its objects. Objects never move once created, so
+// raw pointers stay valid until release(); freed slots are reused before a
+// new slab is allocated, keeping memory bounded by the peak live count.
+// Handles carry a generation so a stale handle to a reused slot resolves to
+// null instead of the new occupant.
+template <typename T, size_t SlabSize = 1024>
+class ObjectPool {
+public:
+    struct Handle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool valid() const { return index != UINT32_MAX; }
+    };
+
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        uint32_t generation = 0;
+        bool live = false;
+
+        T* object() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    std::vector<uint32_t> freeSlots;
+    uint32_t highWater = 0; // slots ever handed out
+    size_t liveCount = 0;
+
+    Slot& slot(uint32_t index) const {
+        return slabs[index / SlabSize][index % SlabSize];
+    }
+
+public:
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    ~ObjectPool() {
+        for (uint32_t i = 0; i < highWater; ++i) {
+            if (slot(i).live) slot(i).object()->~T();
+        }
+    }
+
+    template <typename... Args>
+    Handle emplace(Args&&... args) {
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            if (highWater % SlabSize == 0) {
+                slabs.emplace_back(new Slot[SlabSize]);
+            }
+            index = highWater++;
+        }
+        Slot& s = slot(index);
+        new (s.storage) T(std::forward<Args>(args)...);
+        s.live = true;
+        ++liveCount;
+        return Handle{index, s.generation};
+    }
+
+    T* get(Handle h) const {
+        if (h.index >= highWater) return nullptr;
+        Slot& s = slot(h.index);
+        return s.live && s.generation == h.generation ? s.object() : nullptr;
+    }
+
+    // Live object in slot index, whatever its generation
+    T* at(uint32_t index) const {
+        if (index >= highWater) return nullptr;
+        Slot& s = slot(index);
+        return s.live ? s.object() : nullptr;
+    }
+
+    void release(Handle h) {
+        if (!get(h)) return;
+        Slot& s = slot(h.index);
+        s.object()->~T();
+        s.live = false;
+        ++s.generation;
+        --liveCount;
+        freeSlots.push_back(h.index);
+    }
+
+    // Visit live objects in slot order (slab by slab, contiguous)
+    template <typename F>
+    void forEach(F&& f) const {
+        for (uint32_t i = 0; i < highWater; ++i) {
+            Slot& s = slot(i);
+            if (s.live) f(*s.object());
+        }
+    }
+
+    size_t size() const {
+        return liveCount;
+    }
+
+    // Slot indexes in use are below this
+    uint32_t slotCount() const {
+        return highWater;
+    }
+
+    size_t capacity() const {
+        return slabs.size() * SlabSize;
+    }
+};
+
+#endif // OBJECT_POOL_HPP
@@ -0,0 +1,217 @@
+#ifndef PAGE_FILE_HPP
+#define PAGE_FILE_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+// Spill file for record bodies that are rarely read, with an LRU cache of
+// pages in front of it.
+//
+// Bodies are opaque byte strings appended to 4 KB pages. A body that fits
+// in the space left on the current page is packed there; otherwise it
+// starts a new page, and one longer than a page takes a run of whole pages
+// to itself. A body therefore always lies inside one run that no other
+// run overlaps, so reading it is a cache lookup and, on a miss, a single
+// pread of that run. Cached runs are evicted least recently used first
+// once they exceed the byte budget.
+//
+// Space is never reused: released bodies are only counted as garbage. The
+// file is scratch, truncated when opened and removed when closed.
+//
+// Reads may run concurrently with each other and with appends.
+class PageFile {
+public:
+    static constexpr size_t kPageSize = 4096;
+
+    struct Extent {
+        uint64_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0; // one pread each
+        uint64_t cachedBytes = 0;
+        uint64_t fileBytes = 0;
+        uint64_t garbageBytes = 0;
+    };
+
+private:
+    struct Frame {
+        uint64_t page; // first page of the run
+        std::vector<uint8_t> bytes;
+    };
+
+    int fd = -1;
+    std::string path;
+    size_t budget = 0;
+    uint64_t end = 0;          // next free byte
+    std::vector<uint8_t> tail; // page holding `end`, not yet complete on disk
+
+    mutable std::list<Frame> lru; // most recently used first
+    mutable std::unordered_map<uint64_t, std::list<Frame>::iterator> frames;
+    mutable Stats counters;
+    mutable std::mutex mutex;
+
+    static bool writeAll(int fd, const uint8_t* data, size_t size, uint64_t offset) {
+        while (size > 0) {
+            ssize_t n = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+            offset += static_cast<uint64_t>(n);
+        }
+        return true;
+    }
+
+    static size_t readAll(int fd, uint8_t* data, size_t size, uint64_t offset) {
+        size_t done = 0;
+        while (done < size) {
+            ssize_t n = ::pread(fd, data + done, size - done, static_cast<off_t>(offset + done));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break; // end of file: the last run may be short
+            done += static_cast<size_t>(n);
+        }
+        return done;
+    }
+
+    // Drop least recently used runs until the cache fits the budget
+    void evict() const {
+        while (counters.cachedBytes > budget && !lru.empty()) {
+            counters.cachedBytes -= lru.back().bytes.size();
+            frames.erase(lru.back().page);
+            lru.pop_back();
+        }
+    }
+
+public:
+    PageFile() : tail(kPageSize) {}
+
+    ~PageFile() {
+        close();
+    }
+
+    PageFile(const PageFile&) = delete;
+    PageFile& operator=(const PageFile&) = delete;
+
+    bool open(const std::string& filePath, size_t cacheBytes, std::string& error) {
+        close();
+        fd = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (fd < 0) {
+            error = "cannot open page file '" + filePath + "': " + std::strerror(errno);
+            return false;
+        }
+        path = filePath;
+        budget = cacheBytes;
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fd < 0) return;
+        ::close(fd);
+        ::unlink(path.c_str());
+        fd = -1;
+        end = 0;
+        lru.clear();
+        frames.clear();
+        counters = Stats();
+    }
+
+    bool isOpen() const {
+        return fd >= 0;
+    }
+
+    // Append a body; false (and nothing written) on an I/O error
+    bool append(const std::vector<uint8_t>& body, Extent& where) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fd < 0) return false;
+        size_t used = end % kPageSize;
+        uint64_t offset = end;
+        if (used && body.size() > kPageSize - used) {
+            offset += kPageSize - used; // start a fresh page
+            used = 0;
+        }
+        if (!writeAll(fd, body.data(), body.size(), offset)) return false;
+
+        uint64_t next = offset + body.size();
+        if (body.size() > kPageSize) {
+            next = (next + kPageSize - 1) / kPageSize * kPageSize; // run keeps its last page
+        } else {
+            std::memcpy(tail.data() + used, body.data(), body.size());
+        }
+        where.offset = offset;
+        where.length = static_cast<uint32_t>(body.size());
+        end = next;
+        counters.fileBytes = end;
+        return true;
+    }
+
+    // Copy a body out. Cached or tail-page bodies cost no I/O, anything
+    // else one pread; with cache = false (full scans) the run read is not
+    // kept, so a scan does not flush the working set.
+    bool read(const Extent& where, std::vector<uint8_t>& out, bool cache = true) const {
+        uint64_t first = where.offset / kPageSize;
+        size_t start = where.offset % kPageSize;
+        size_t runBytes = (start + where.length + kPageSize - 1) / kPageSize * kPageSize;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (fd < 0 || where.offset + where.length > end) return false;
+            if (first == end / kPageSize && end % kPageSize) {
+                out.assign(tail.begin() + start, tail.begin() + start + where.length);
+                return true;
+            }
+            auto it = frames.find(first);
+            if (it != frames.end()) {
+                lru.splice(lru.begin(), lru, it->second);
+                const std::vector<uint8_t>& bytes = it->second->bytes;
+                out.assign(bytes.begin() + start, bytes.begin() + start + where.length);
+                ++counters.hits;
+                return true;
+            }
+            ++counters.misses;
+        }
+
+        std::vector<uint8_t> bytes(runBytes);
+        size_t got = readAll(fd, bytes.data(), bytes.size(), first * kPageSize);
+        if (got < start + where.length) return false;
+        out.assign(bytes.begin() + start, bytes.begin() + start + where.length);
+        if (!cache || runBytes > budget) return true;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (frames.count(first)) return true; // another reader cached it first
+        lru.push_front(Frame{first, std::move(bytes)});
+        frames[first] = lru.begin();
+        counters.cachedBytes += runBytes;
+        evict();
+        return true;
+    }
+
+    // Forget a body; its bytes stay in the file until it is reopened
+    void release(const Extent& where) {
+        std::lock_guard<std::mutex> lock(mutex);
+        counters.garbageBytes += where.length;
+    }
+
+    void setBudget(size_t cacheBytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        budget = cacheBytes;
+        evict();
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return counters;
+    }
+};
+
+#endif // PAGE_FILE_HPP
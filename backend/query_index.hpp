@@ -0,0 +1,204 @@
+#ifndef QUERY_INDEX_HPP
+#define QUERY_INDEX_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Secondary indexes used by the /api/fir/query planner. All of them are
+// keyed by row (the record pool slot), which is reused along with the slot.
+// Postings are sorted row vectors so they can be merged and intersected.
+using RowList = std::vector<uint32_t>;
+
+inline void insertRow(RowList& rows, uint32_t row) {
+    if (rows.empty() || rows.back() < row) {
+        rows.push_back(row);
+        return;
+    }
+    auto it = std::lower_bound(rows.begin(), rows.end(), row);
+    if (it == rows.end() || *it != row) rows.insert(it, row);
+}
+
+inline void eraseRow(RowList& rows, uint32_t row) {
+    auto it = std::lower_bound(rows.begin(), rows.end(), row);
+    if (it != rows.end() && *it == row) rows.erase(it);
+}
+
+inline RowList intersectRows(const RowList& a, const RowList& b) {
+    RowList out;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+    return out;
+}
+
+inline RowList unionRows(const RowList& a, const RowList& b) {
+    RowList out;
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+    return out;
+}
+
+// One bit per row
+class RowBitmap {
+private:
+    std::vector<uint64_t> words;
+    size_t count = 0;
+
+public:
+    void set(uint32_t row) {
+        size_t w = row >> 6;
+        if (w >= words.size()) words.resize(w + 1, 0);
+        uint64_t bit = uint64_t(1) << (row & 63);
+        if (!(words[w] & bit)) {
+            words[w] |= bit;
+            count++;
+        }
+    }
+
+    void clear(uint32_t row) {
+        size_t w = row >> 6;
+        if (w >= words.size()) return;
+        uint64_t bit = uint64_t(1) << (row & 63);
+        if (words[w] & bit) {
+            words[w] &= ~bit;
+            count--;
+        }
+    }
+
+    bool test(uint32_t row) const {
+        size_t w = row >> 6;
+        return w < words.size() && (words[w] >> (row & 63) & 1);
+    }
+
+    RowList rows() const {
+        RowList out;
+        out.reserve(count);
+        for (size_t w = 0; w < words.size(); ++w) {
+            for (uint64_t bits = words[w]; bits; bits &= bits - 1) {
+                out.push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits)));
+            }
+        }
+        return out;
+    }
+
+    size_t size() const {
+        return count;
+    }
+};
+
+// Equality index: one bitmap per distinct value. Keyed by intern id for a
+// dictionary-coded field (status, district, ...), or by the text itself
+// for free text (location); a value's entry goes with its last row.
+template <typename Key>
+class KeyedBitmapIndex {
+private:
+    std::unordered_map<Key, RowBitmap> bitmaps;
+
+public:
+    void add(const Key& key, uint32_t row) {
+        bitmaps[key].set(row);
+    }
+
+    void remove(const Key& key, uint32_t row) {
+        auto it = bitmaps.find(key);
+        if (it == bitmaps.end()) return;
+        it->second.clear(row);
+        if (!it->second.size()) bitmaps.erase(it);
+    }
+
+    const RowBitmap* find(const Key& key) const {
+        auto it = bitmaps.find(key);
+        return it != bitmaps.end() ? &it->second : nullptr;
+    }
+
+    size_t count(const Key& key) const {
+        const RowBitmap* bitmap = find(key);
+        return bitmap ? bitmap->size() : 0;
+    }
+};
+
+using BitmapIndex = KeyedBitmapIndex<uint32_t>;
+using TextBitmapIndex = KeyedBitmapIndex<std::string>;
+
+// Ordered day -> rows index for date ranges
+class DateIndex {
+private:
+    std::map<int32_t, RowList> byDay;
+
+public:
+    void add(int32_t day, uint32_t row) {
+        insertRow(byDay[day], row);
+    }
+
+    void remove(int32_t day, uint32_t row) {
+        auto it = byDay.find(day);
+        if (it == byDay.end()) return;
+        eraseRow(it->second, row);
+        if (it->second.empty()) byDay.erase(it);
+    }
+
+    size_t count(int32_t from, int32_t to) const {
+        size_t n = 0;
+        for (auto it = byDay.lower_bound(from); it != byDay.end() && it->first <= to; ++it) {
+            n += it->second.size();
+        }
+        return n;
+    }
+
+    RowList rows(int32_t from, int32_t to) const {
+        RowList out;
+        for (auto it = byDay.lower_bound(from); it != byDay.end() && it->first <= to; ++it) {
+            out.insert(out.end(), it->second.begin(), it->second.end());
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+};
+
+// Inverted word index over free text. Words are lowercase alphanumeric runs.
+class TextIndex {
+private:
+    std::unordered_map<std::string, RowList> postings;
+
+public:
+    static std::vector<std::string> words(const std::string& text) {
+        std::vector<std::string> out;
+        std::string word;
+        for (size_t i = 0; i <= text.size(); ++i) {
+            unsigned char ch = i < text.size() ? text[i] : ' ';
+            if (std::isalnum(ch)) {
+                word.push_back(static_cast<char>(std::tolower(ch)));
+            } else if (!word.empty()) {
+                out.push_back(word);
+                word.clear();
+            }
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        return out;
+    }
+
+    void add(const std::string& text, uint32_t row) {
+        for (const auto& word : words(text)) {
+            insertRow(postings[word], row);
+        }
+    }
+
+    void remove(const std::string& text, uint32_t row) {
+        for (const auto& word : words(text)) {
+            auto it = postings.find(word);
+            if (it == postings.end()) continue;
+            eraseRow(it->second, row);
+            if (it->second.empty()) postings.erase(it);
+        }
+    }
+
+    const RowList* find(const std::string& word) const {
+        auto it = postings.find(word);
+        return it != postings.end() ? &it->second : nullptr;
+    }
+};
+
+#endif // QUERY_INDEX_HPP
@@ -0,0 +1,200 @@
+#ifndef RATE_COUNTER_HPP
+#define RATE_COUNTER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+// Rolling event counts per key (a police station) over the last minute,
+// hour and day, for spotting incident spikes.
+//
+// Writers never share a cache line or take a lock: every CPU has its own
+// shard, and each shard keeps, per key, three rings of time buckets
+// (60 seconds, 60 minutes, 24 hours). A bucket is one 64-bit atomic
+// holding the time unit it belongs to in the high half and the count in
+// the low half, so a stale bucket is reset and counted into with a single
+// CAS. Readers sum the buckets that are still inside the window across
+// all shards.
+//
+// Keys are small integers. The key table is open-addressed with a fixed
+// capacity and claimed by CAS; keys beyond it, and kOverflowKey, share the
+// last slot. Shard rows are allocated on first use.
+class RateCounter {
+public:
+    static constexpr size_t kMaxKeys = 4096;
+    // Counted in the shared last slot without claiming a table entry, so
+    // callers with more keys than fit can route the rest here and read
+    // their total back with rates(kOverflowKey)
+    static constexpr uint32_t kOverflowKey = kMaxKeys - 1;
+
+    struct Rates {
+        uint64_t lastMinute = 0;
+        uint64_t lastHour = 0;
+        uint64_t lastDay = 0;
+    };
+
+private:
+    static constexpr size_t kSeconds = 60;
+    static constexpr size_t kMinutes = 60;
+    static constexpr size_t kHours = 24;
+
+    struct alignas(64) Row {
+        std::atomic<uint64_t> seconds[kSeconds];
+        std::atomic<uint64_t> minutes[kMinutes];
+        std::atomic<uint64_t> hours[kHours];
+
+        Row() {
+            for (auto& b : seconds) b.store(0, std::memory_order_relaxed);
+            for (auto& b : minutes) b.store(0, std::memory_order_relaxed);
+            for (auto& b : hours) b.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    struct Shard {
+        std::unique_ptr<std::atomic<Row*>[]> rows;
+
+        Shard() : rows(new std::atomic<Row*>[kMaxKeys]) {
+            for (size_t i = 0; i < kMaxKeys; ++i) rows[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~Shard() {
+            for (size_t i = 0; i < kMaxKeys; ++i) delete rows[i].load(std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<Shard> shards;
+    std::unique_ptr<std::atomic<uint32_t>[]> keys; // key + 1, 0 = empty slot
+
+    static uint64_t nowSeconds() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    size_t shardIndex() const {
+#if defined(__linux__)
+        int cpu = sched_getcpu();
+        if (cpu >= 0) return static_cast<size_t>(cpu) % shards.size();
+#endif
+        static std::atomic<size_t> nextThread{0};
+        thread_local size_t assigned = nextThread.fetch_add(1, std::memory_order_relaxed);
+        return assigned % shards.size();
+    }
+
+    // Slot for key, claiming one if needed
+    size_t slotFor(uint32_t key) {
+        if (key == kOverflowKey) return kMaxKeys - 1;
+        uint32_t tag = key + 1;
+        size_t start = (key * 2654435761u) % kMaxKeys;
+        for (size_t probe = 0; probe < kMaxKeys - 1; ++probe) {
+            size_t slot = (start + probe) % (kMaxKeys - 1);
+            uint32_t current = keys[slot].load(std::memory_order_acquire);
+            if (current == tag) return slot;
+            if (current == 0 && keys[slot].compare_exchange_strong(current, tag, std::memory_order_acq_rel)) {
+                return slot;
+            }
+            if (current == tag) return slot;
+        }
+        return kMaxKeys - 1; // overflow slot
+    }
+
+    // Slot for key if present, kMaxKeys otherwise; never claims
+    size_t findSlot(uint32_t key) const {
+        if (key == kOverflowKey) return kMaxKeys - 1;
+        uint32_t tag = key + 1;
+        size_t start = (key * 2654435761u) % kMaxKeys;
+        for (size_t probe = 0; probe < kMaxKeys - 1; ++probe) {
+            size_t slot = (start + probe) % (kMaxKeys - 1);
+            uint32_t current = keys[slot].load(std::memory_order_acquire);
+            if (current == tag) return slot;
+            if (current == 0) return kMaxKeys;
+        }
+        return kMaxKeys;
+    }
+
+    static void bump(std::atomic<uint64_t>& bucket, uint64_t unit) {
+        uint64_t current = bucket.load(std::memory_order_relaxed);
+        while (true) {
+            if ((current >> 32) == (unit & 0xffffffffu)) {
+                bucket.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            uint64_t fresh = (unit << 32) | 1;
+            if (bucket.compare_exchange_weak(current, fresh, std::memory_order_relaxed)) return;
+        }
+    }
+
+    // Sum of buckets whose unit lies in (now - span, now]
+    template <size_t N>
+    static uint64_t window(const std::atomic<uint64_t> (&ring)[N], uint64_t now, uint64_t span) {
+        uint64_t total = 0;
+        for (const auto& bucket : ring) {
+            uint64_t value = bucket.load(std::memory_order_relaxed);
+            uint64_t unit = value >> 32;
+            if (unit <= (now & 0xffffffffu) && (now & 0xffffffffu) - unit < span) {
+                total += value & 0xffffffffu;
+            }
+        }
+        return total;
+    }
+
+    Row& rowFor(size_t shard, size_t slot) {
+        std::atomic<Row*>& cell = shards[shard].rows[slot];
+        Row* row = cell.load(std::memory_order_acquire);
+        if (row) return *row;
+        Row* created = new Row();
+        if (cell.compare_exchange_strong(row, created, std::memory_order_acq_rel)) return *created;
+        delete created;
+        return *row;
+    }
+
+public:
+    explicit RateCounter(size_t shardCount = std::thread::hardware_concurrency())
+        : shards(shardCount ? shardCount : 1), keys(new std::atomic<uint32_t>[kMaxKeys]) {
+        for (size_t i = 0; i < kMaxKeys; ++i) keys[i].store(0, std::memory_order_relaxed);
+    }
+
+    RateCounter(const RateCounter&) = delete;
+    RateCounter& operator=(const RateCounter&) = delete;
+
+    // Count one event for key now
+    void record(uint32_t key) {
+        uint64_t now = nowSeconds();
+        Row& row = rowFor(shardIndex(), slotFor(key));
+        bump(row.seconds[now % kSeconds], now);
+        bump(row.minutes[(now / 60) % kMinutes], now / 60);
+        bump(row.hours[(now / 3600) % kHours], now / 3600);
+    }
+
+    Rates rates(uint32_t key) const {
+        Rates result;
+        size_t slot = findSlot(key);
+        if (slot == kMaxKeys) return result;
+        uint64_t now = nowSeconds();
+        for (const auto& shard : shards) {
+            const Row* row = shard.rows[slot].load(std::memory_order_acquire);
+            if (!row) continue;
+            result.lastMinute += window(row->seconds, now, kSeconds);
+            result.lastHour += window(row->minutes, now / 60, kMinutes);
+            result.lastDay += window(row->hours, now / 3600, kHours);
+        }
+        return result;
+    }
+
+    // Every key seen so far (the overflow slot is not included)
+    std::vector<uint32_t> keysSeen() const {
+        std::vector<uint32_t> out;
+        for (size_t slot = 0; slot < kMaxKeys - 1; ++slot) {
+            uint32_t tag = keys[slot].load(std::memory_order_acquire);
+            if (tag) out.push_back(tag - 1);
+        }
+        return out;
+    }
+};
+
+#endif // RATE_COUNTER_HPP
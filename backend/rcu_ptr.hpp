@@ -0,0 +1,80 @@
+#ifndef RCU_PTR_HPP
+#define RCU_PTR_HPP
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Read-mostly pointer with RCU-style publication. Readers pin the current
+// object with two atomic increments and never wait; publish() swaps in a new
+// object and then waits for readers that may still see the old one to drain
+// (two epoch flips, as in SRCU) before deleting it. Writers are serialized.
+template <typename T>
+class RcuPtr {
+private:
+    struct alignas(64) Counter {
+        std::atomic<long> readers{0};
+    };
+
+    std::atomic<T*> current{nullptr};
+    std::atomic<unsigned> epoch{0};
+    mutable Counter active[2];
+    std::mutex writerMutex;
+
+public:
+    class ReadGuard {
+    private:
+        const RcuPtr* owner;
+        unsigned slot;
+        const T* ptr;
+
+    public:
+        ReadGuard(const RcuPtr* o, unsigned s, const T* p) : owner(o), slot(s), ptr(p) {}
+        ReadGuard(ReadGuard&& other) noexcept : owner(other.owner), slot(other.slot), ptr(other.ptr) {
+            other.owner = nullptr;
+        }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+
+        ~ReadGuard() {
+            if (owner) owner->active[slot].readers.fetch_sub(1);
+        }
+
+        const T* get() const { return ptr; }
+        const T* operator->() const { return ptr; }
+        const T& operator*() const { return *ptr; }
+        explicit operator bool() const { return ptr != nullptr; }
+    };
+
+    RcuPtr() = default;
+    RcuPtr(const RcuPtr&) = delete;
+    RcuPtr& operator=(const RcuPtr&) = delete;
+
+    ~RcuPtr() {
+        delete current.load();
+    }
+
+    // Pin the current object for the lifetime of the guard
+    ReadGuard read() const {
+        unsigned slot = epoch.load() & 1;
+        active[slot].readers.fetch_add(1);
+        return ReadGuard(this, slot, current.load());
+    }
+
+    // Install next and free the previous object once no reader can hold it
+    void publish(std::unique_ptr<T> next) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        T* old = current.exchange(next.release());
+        for (int flip = 0; flip < 2; ++flip) {
+            unsigned slot = epoch.fetch_add(1) & 1;
+            while (active[slot].readers.load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+        delete old;
+    }
+};
+
+#endif // RCU_PTR_HPP
@@ -0,0 +1,228 @@
+/**
+ * Record file benchmark: compression ratio and load throughput
+ * Builds two synthetic FIR corpora - "templated" (descriptions and
+ * addresses from common phrasings, like real complaints) and "random"
+ * (descriptions drawn from a 2000-word random vocabulary, the worst case
+ * for a dictionary) - as MessagePack records, the form the FIR store
+ * keeps. Each corpus is written as pretty-printed JSON, the old export,
+ * and as record files over a grid of block and dictionary sizes. For
+ * each it reports file size, write speed and load speed (read, check,
+ * decompress and decode every record), then verifies the records.
+ *
+ * Compile: g++ -std=c++17 -O2 record_file_bench.cpp -o record_file_bench -lpthread
+ * Run: ./record_file_bench [records]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "json.hpp"
+#include "record_file.hpp"
+
+using json = nlohmann::json;
+
+static const char* kDistricts[] = {"Pune", "Mumbai", "Nagpur", "Nashik", "Thane", "Solapur", "Kolhapur", "Satara"};
+static const char* kFirst[] = {"Ravi", "Asha", "Imran", "Priya", "Suresh", "Meena", "Arjun", "Fatima", "Vikram", "Sunita"};
+static const char* kLast[] = {"Kumar", "Deshmukh", "Shaikh", "Nair", "Patil", "Joshi", "Khan", "Kulkarni", "Rao", "Pawar"};
+static const char* kAreas[] = {"Shivaji Nagar", "Kothrud", "Hadapsar", "Camp", "Aundh", "Wakad", "Baner", "Sadar"};
+static const char* kItems[] = {"mobile phone", "gold chain", "wallet", "motorcycle", "laptop", "handbag", "bicycle"};
+static const char* kPlaces[] = {"the bus stand", "the vegetable market", "the railway station", "her residence",
+                                "the ATM", "the temple", "the college gate"};
+static const char* kTemplates[] = {
+    "The complainant states that on the said date at about {time} unknown persons stole his {item} near {place}. "
+    "The accused fled on a motorcycle towards {area}.",
+    "The complainant reported that her {item} was snatched near {place} by two unknown persons. "
+    "She raised an alarm but the accused escaped towards {area}.",
+    "The complainant alleges that the accused {suspect} threatened him with a knife near {place} and took his {item}.",
+    "The complainant states that someone called him posing as a bank officer and withdrew money using his card "
+    "details. He noticed the loss near {place}.",
+    "The complainant reported that her house at {area} was broken into while she was away and her {item} was "
+    "missing."};
+static const char* kStatuses[] = {"pending", "under_investigation", "closed"};
+static const char* kSections[] = {"379", "392", "420", "454", "457", "506", "323"};
+
+static void replace(std::string& text, const std::string& slot, const std::string& value) {
+    for (size_t at = text.find(slot); at != std::string::npos; at = text.find(slot, at + value.size())) {
+        text.replace(at, slot.size(), value);
+    }
+}
+
+// The fields and key order of FIRRecord::toJSON()
+static json firRecord(size_t i, bool templated, std::mt19937& rng, const std::vector<std::string>& vocabulary) {
+    auto pick = [&rng](size_t n) { return static_cast<size_t>(rng() % n); };
+    std::string name = std::string(kFirst[pick(10)]) + " " + kLast[pick(10)];
+    std::string suspect = pick(3) ? "Unknown" : std::string(kFirst[pick(10)]) + " " + kLast[pick(10)];
+    std::string area = kAreas[pick(8)];
+    char time[6];
+    std::snprintf(time, sizeof(time), "%02zu:%02zu", pick(24), pick(60));
+    char date[11];
+    std::snprintf(date, sizeof(date), "2025-%02zu-%02zu", 1 + pick(12), 1 + pick(28));
+
+    std::string description;
+    if (templated) {
+        description = kTemplates[pick(5)];
+        replace(description, "{time}", time);
+        replace(description, "{item}", kItems[pick(7)]);
+        replace(description, "{place}", kPlaces[pick(7)]);
+        replace(description, "{area}", area);
+        replace(description, "{suspect}", suspect);
+    } else {
+        for (int w = 0; w < 30; ++w) description += vocabulary[pick(vocabulary.size())] + " ";
+        name = vocabulary[pick(vocabulary.size())] + " " + vocabulary[pick(vocabulary.size())];
+    }
+    json sections = json::array();
+    for (size_t s = 0, n = 1 + pick(2); s < n; ++s) sections.push_back(kSections[pick(7)]);
+
+    json j;
+    j["id"] = "FIR-" + std::to_string(i + 1);
+    j["district"] = kDistricts[pick(8)];
+    j["policeStation"] = area + " Police Station";
+    j["complainantName"] = name;
+    j["complainantFatherName"] = std::string(kFirst[pick(10)]) + " " + kLast[pick(10)];
+    j["complainantAddress"] = "House " + std::to_string(1 + pick(500)) + ", " + area + ", Pune";
+    j["complainantPhone"] = std::to_string(9000000000ULL + rng() % 1000000000ULL);
+    j["complainantEmail"] = "user" + std::to_string(rng() % 100000) + "@example.com";
+    j["dateOfIncident"] = date;
+    j["timeOfIncident"] = time;
+    j["placeOfIncident"] = kPlaces[pick(7)];
+    j["incidentDescription"] = description;
+    j["suspectName"] = suspect;
+    j["suspectAge"] = pick(2) ? "" : std::to_string(18 + pick(40));
+    j["suspectAddress"] = "";
+    j["suspectDescription"] = pick(2) ? "" : "Medium build, wearing a black jacket";
+    j["propertyDescription"] = templated ? std::string(kItems[pick(7)]) + ", approx value Rs. " +
+                                               std::to_string(1000 * (1 + pick(90)))
+                                         : "";
+    j["ipcSections"] = sections;
+    j["ipcSectionsSource"] = pick(2) ? "officer" : "suggested";
+    j["timestamp"] = std::string(date) + " " + time + ":00";
+    j["status"] = kStatuses[pick(3)];
+    return j;
+}
+
+// What the server seeds its dictionary with: an empty record
+static std::string seedRecord() {
+    json j;
+    for (const char* key : {"id", "district", "policeStation", "complainantName", "complainantFatherName",
+                            "complainantAddress", "complainantPhone", "complainantEmail", "dateOfIncident",
+                            "timeOfIncident", "placeOfIncident", "incidentDescription", "suspectName",
+                            "suspectAge", "suspectAddress", "suspectDescription", "propertyDescription",
+                            "ipcSectionsSource", "timestamp", "status"}) {
+        j[key] = "";
+    }
+    j["ipcSections"] = json::array();
+    std::vector<uint8_t> bytes = json::to_msgpack(j);
+    return std::string(bytes.begin(), bytes.end());
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static uint64_t fileSize(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    return static_cast<uint64_t>(in.tellg());
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000;
+    const std::string path = "record_file_bench.tmp";
+    int failures = 0;
+
+    std::mt19937 rng(5);
+    std::vector<std::string> vocabulary(2000);
+    for (auto& word : vocabulary) {
+        for (size_t c = 0, n = 4 + rng() % 5; c < n; ++c) word.push_back(static_cast<char>('a' + rng() % 26));
+    }
+    std::string seed = seedRecord();
+
+    for (bool templated : {true, false}) {
+        std::vector<std::string> records;
+        json all = json::array();
+        uint64_t rawBytes = 0;
+        for (size_t i = 0; i < count; ++i) {
+            json record = firRecord(i, templated, rng, vocabulary);
+            std::vector<uint8_t> bytes = json::to_msgpack(record);
+            records.emplace_back(bytes.begin(), bytes.end());
+            rawBytes += bytes.size();
+            all.push_back(std::move(record));
+        }
+        std::cout << (templated ? "Templated" : "Random") << " corpus: " << count << " FIRs, "
+                  << rawBytes / (1024.0 * 1024.0) << " MiB as MessagePack" << std::endl;
+
+        // Old export: one pretty-printed array
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out << all.dump(4);
+        }
+        double writeSeconds = secondsSince(start);
+        uint64_t jsonBytes = fileSize(path);
+
+        // ratio: JSON export size / size; speeds in FIRs per second
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "  format               size MiB  ratio  write kFIR/s  load kFIR/s" << std::endl;
+        auto row = [&](const std::string& label, uint64_t bytes, double writeSeconds, double loadSeconds) {
+            std::cout << "  " << std::left << std::setw(20) << label << std::right << std::setw(9)
+                      << bytes / (1024.0 * 1024.0) << std::setw(7) << double(jsonBytes) / bytes << std::setw(14)
+                      << count / writeSeconds / 1000 << std::setw(13) << count / loadSeconds / 1000 << std::endl;
+        };
+        start = std::chrono::steady_clock::now();
+        {
+            std::ifstream in(path, std::ios::binary);
+            json loaded;
+            in >> loaded;
+            if (loaded.size() != count) ++failures;
+        }
+        row("json dump(4)", jsonBytes, writeSeconds, secondsSince(start));
+
+        for (size_t blockBytes : {4 << 10, 16 << 10, 64 << 10}) {
+            for (size_t dictionaryBytes : {size_t(0), seed.size(), size_t(8 << 10), size_t(32 << 10), size_t(64 << 10)}) {
+                RecordFile::Options options;
+                options.blockBytes = blockBytes;
+                options.dictionaryBytes = dictionaryBytes;
+                std::string error;
+                start = std::chrono::steady_clock::now();
+                RecordFile::Writer writer;
+                bool ok = writer.open(path, seed, options, error);
+                for (size_t i = 0; ok && i < records.size(); ++i) ok = writer.add(records[i], error);
+                ok = ok && writer.finish(error);
+                writeSeconds = secondsSince(start);
+                if (!ok) {
+                    std::cerr << error << std::endl;
+                    return 1;
+                }
+
+                size_t seen = 0;
+                start = std::chrono::steady_clock::now();
+                ok = RecordFile::read(path, [&](const std::string& record) {
+                    json decoded = json::from_msgpack(record);
+                    if (seen < records.size() && record != records[seen]) ++failures;
+                    seen += decoded.is_object();
+                }, error);
+                double loadSeconds = secondsSince(start);
+                if (!ok || seen != records.size()) {
+                    ++failures;
+                    std::cerr << "MISMATCH: " << error << " (" << seen << " records)" << std::endl;
+                }
+                std::string dictionary = dictionaryBytes == 0 ? "none"
+                                       : dictionaryBytes == seed.size() ? "seed"
+                                       : std::to_string(dictionaryBytes >> 10) + "K";
+                row("block " + std::to_string(blockBytes >> 10) + "K dict " + dictionary, fileSize(path),
+                    writeSeconds, loadSeconds);
+            }
+        }
+        std::cout << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+    std::remove(path.c_str());
+
+    std::cout << (failures ? "FAILED: " + std::to_string(failures) + " mismatches" : "All records match")
+              << std::endl;
+    return failures ? 1 : 0;
+}
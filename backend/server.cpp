@@ -2,6 +2,7 @@
 #include <fstream>
 #include <sstream>
 #include <ctime>
+#include <cstdio>
 #include "httplib.h"
 #include "fir_store.hpp"
 #include "ipc_store.hpp"
@@ -33,14 +34,65 @@ Json::Value recordsToJson(const std::vector<FIRRecord*>& records) {
 }
 
 // Helper function to convert vector of IPCSections to JSON array
-Json::Value sectionsToJson(const std::vector<IPCSection>& sections) {
+Json::Value sectionsToJson(const std::vector<const IPCSection*>& sections) {
     Json::Value arr(Json::arrayValue);
-    for (const auto& section : sections) {
-        arr.append(section.toJson());
+    for (const auto* section : sections) {
+        arr.append(toJson(*section));
     }
     return arr;
 }
 
+// Helper function to convert suggested sections to JSON array
+Json::Value matchesToJson(const std::vector<SectionMatch>& matches) {
+    Json::Value arr(Json::arrayValue);
+    for (const auto& match : matches) {
+        Json::Value item;
+        item["section"] = jsonText(match.section->section);
+        item["act"] = jsonText(match.section->act);
+        item["title"] = jsonText(match.section->title);
+        item["score"] = match.score;
+        Json::Value keywords(Json::arrayValue);
+        for (const auto& kw : match.matchedKeywords) {
+            keywords.append(jsonText(kw));
+        }
+        item["matchedKeywords"] = keywords;
+        arr.append(item);
+    }
+    return arr;
+}
+
+// Statuses and IPC sections are interned, and interned text is never
+// freed, so a request naming a status outside kFIRStatuses or a section
+// the live catalog lacks is refused here; true if the response was sent
+bool rejectRequest(const Json::Value& reqJson, httplib::Response& res) {
+    std::string error;
+    const Json::Value& status = reqJson["status"];
+    if (reqJson.isMember("status") && !(status.isString() && isKnownStatus(status.asString()))) {
+        error = "status must be one of open, closed, under_investigation";
+    }
+    if (error.empty() && reqJson.isMember("ipcSections")) {
+        IPCStore::Snapshot catalog = ipcStore.current();
+        for (const auto& section : reqJson["ipcSections"]) {
+            if (!section.isString()) {
+                error = "ipcSections must be strings";
+                break;
+            }
+            if (!catalog->getBySection(section.asString())) {
+                error = "unknown IPC section " + section.asString();
+                break;
+            }
+        }
+    }
+    if (error.empty()) return false;
+
+    Json::Value response;
+    response["success"] = false;
+    response["error"] = error;
+    res.set_header("Access-Control-Allow-Origin", "*");
+    res.set_content(Json::writeString(Json::StreamWriterBuilder(), response), "application/json");
+    return true;
+}
+
 int main() {
     httplib::Server svr;
 
@@ -76,29 +128,46 @@ int main() {
         Json::Value reqJson;
         Json::Reader reader;
         reader.parse(req.body, reqJson);
-
-        FIRRecord* record = new FIRRecord();
-        record->id = reqJson.get("id", static_cast<int>(std::time(nullptr))).asInt();
-        record->complainant = reqJson["complainant"].asString();
-        record->suspect = reqJson["suspect"].asString();
-        record->location = reqJson["location"].asString();
-        record->description = reqJson["description"].asString();
-        record->date = reqJson.get("date", "").asString();
-        record->status = reqJson.get("status", "open").asString();
+        if (rejectRequest(reqJson, res)) return;
+
+        FIRRecord record;
+        record.id = reqJson.get("id", static_cast<int>(std::time(nullptr))).asInt();
+        record.complainant = reqJson["complainant"].asString();
+        record.suspect = reqJson["suspect"].asString();
+        record.location = reqJson["location"].asString();
+        record.description = reqJson["description"].asString();
+        record.date = reqJson.get("date", "").asString();
+        record.status = reqJson.get("status", "open").asString();
+        record.suspectPhone = reqJson.get("suspectPhone", "").asString();
+        record.suspectAddress = reqJson.get("suspectAddress", "").asString();
+        record.district = reqJson.get("district", "").asString();
+        record.policeStation = reqJson.get("policeStation", "").asString();
+        for (const auto& section : reqJson["ipcSections"]) {
+            record.ipcSections.push_back(section.asString());
+        }
 
         for (const auto& tag : reqJson["tags"]) {
-            record->tags.push_back(tag.asString());
+            record.tags.push_back(tag.asString());
         }
 
         for (const auto& relId : reqJson["relatedIds"]) {
-            record->relatedIds.push_back(relId.asInt());
+            record.relatedIds.push_back(relId.asInt());
         }
 
-        firStore.add(record);
+        auto lock = firStore.writeLock();
+        FIRStore::AddResult added = firStore.add(std::move(record));
+
+        Json::Value linkedArray(Json::arrayValue);
+        for (int linkId : added.autoLinked) {
+            linkedArray.append(linkId);
+        }
 
         Json::Value response;
         response["success"] = true;
-        response["record"] = record->toJson();
+        response["record"] = added.record->toJson();
+        response["autoLinkedIds"] = linkedArray;
+        IPCStore::Snapshot catalog = ipcStore.current();
+        response["suggestedSections"] = matchesToJson(catalog->suggestSections(added.record->description, 5));
 
         Json::StreamWriterBuilder builder;
         res.set_header("Access-Control-Allow-Origin", "*");
@@ -108,6 +177,7 @@ int main() {
     // GET /api/fir/:id
     svr.Get(R"(/api/fir/(\d+))", [](const httplib::Request& req, httplib::Response& res) {
         int id = std::stoi(req.matches[1]);
+        auto lock = firStore.readLock();
         FIRRecord* record = firStore.getById(id);
 
         Json::Value response;
@@ -124,9 +194,113 @@ int main() {
         res.set_content(Json::writeString(builder, response), "application/json");
     });
 
+    // GET /api/fir/:id/related?depth=k&limit=n
+    svr.Get(R"(/api/fir/(\d+)/related)", [](const httplib::Request& req, httplib::Response& res) {
+        int id = std::stoi(req.matches[1]);
+        int depth = 2;
+        int limit = 100;
+        if (req.has_param("depth")) depth = std::atoi(req.get_param_value("depth").c_str());
+        if (req.has_param("limit")) limit = std::atoi(req.get_param_value("limit").c_str());
+        depth = std::max(1, std::min(depth, 4));
+        limit = std::max(1, std::min(limit, 1000));
+
+        auto lock = firStore.readLock();
+        Subgraph sub = firStore.relatedWithin(id, depth, static_cast<size_t>(limit));
+
+        Json::Value response;
+        if (sub.vertices.empty()) {
+            response["success"] = false;
+            response["message"] = "Record not found";
+        } else {
+            Json::Value nodes(Json::arrayValue);
+            for (size_t i = 0; i < sub.vertices.size(); ++i) {
+                Json::Value node;
+                node["id"] = sub.vertices[i];
+                node["depth"] = sub.depths[i];
+                FIRRecord* record = firStore.getById(sub.vertices[i]);
+                if (record) node["record"] = record->toJson();
+                nodes.append(node);
+            }
+
+            Json::Value edges(Json::arrayValue);
+            for (const auto& edge : sub.edges) {
+                Json::Value pair(Json::arrayValue);
+                pair.append(edge.first);
+                pair.append(edge.second);
+                edges.append(pair);
+            }
+
+            response["success"] = true;
+            response["root"] = id;
+            response["depth"] = depth;
+            response["nodes"] = nodes;
+            response["edges"] = edges;
+            response["truncated"] = sub.truncated;
+        }
+
+        Json::StreamWriterBuilder builder;
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_content(Json::writeString(builder, response), "application/json");
+    });
+
+    // GET /api/fir/:id/cluster
+    svr.Get(R"(/api/fir/(\d+)/cluster)", [](const httplib::Request& req, httplib::Response& res) {
+        int id = std::stoi(req.matches[1]);
+        // Exclusive: union-find lookups compress paths, and clusters are
+        // rebuilt here after deletes
+        auto lock = firStore.writeLock();
+        UnionFind& clusters = firStore.caseClusters();
+
+        Json::Value response;
+        if (!clusters.contains(id)) {
+            response["success"] = false;
+            response["message"] = "Record not found";
+        } else {
+            Json::Value members(Json::arrayValue);
+            for (int memberId : clusters.members(id, 100)) {
+                members.append(memberId);
+            }
+            response["success"] = true;
+            response["clusterId"] = clusters.clusterOf(id);
+            response["size"] = static_cast<Json::UInt64>(clusters.clusterSize(id));
+            response["members"] = members;
+        }
+
+        Json::StreamWriterBuilder builder;
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_content(Json::writeString(builder, response), "application/json");
+    });
+
+    // GET /api/fir/clusters/largest?k=n
+    svr.Get("/api/fir/clusters/largest", [](const httplib::Request& req, httplib::Response& res) {
+        int k = 10;
+        if (req.has_param("k")) k = std::atoi(req.get_param_value("k").c_str());
+        k = std::max(1, std::min(k, 100));
+
+        Json::Value clustersJson(Json::arrayValue);
+        // Exclusive: clusters are rebuilt here after deletes
+        auto lock = firStore.writeLock();
+        for (const auto& entry : firStore.caseClusters().largest(static_cast<size_t>(k))) {
+            Json::Value cluster;
+            cluster["clusterId"] = entry.first;
+            cluster["size"] = static_cast<Json::UInt64>(entry.second);
+            clustersJson.append(cluster);
+        }
+
+        Json::Value response;
+        response["success"] = true;
+        response["clusterCount"] = static_cast<Json::UInt64>(firStore.caseClusters().clusterCount());
+        response["clusters"] = clustersJson;
+
+        Json::StreamWriterBuilder builder;
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_content(Json::writeString(builder, response), "application/json");
+    });
+
     // GET /api/fir/search/complainant/:name
     svr.Get(R"(/api/fir/search/complainant/(.+))", [](const httplib::Request& req, httplib::Response& res) {
         std::string name = req.matches[1];
+        auto lock = firStore.readLock();
         auto records = firStore.searchComplainant(name);
 
         Json::Value response;
@@ -141,6 +315,7 @@ int main() {
     // GET /api/fir/search/suspect/:name
     svr.Get(R"(/api/fir/search/suspect/(.+))", [](const httplib::Request& req, httplib::Response& res) {
         std::string name = req.matches[1];
+        auto lock = firStore.readLock();
         auto records = firStore.searchSuspect(name);
 
         Json::Value response;
@@ -155,6 +330,7 @@ int main() {
     // GET /api/fir/status/:status
     svr.Get(R"(/api/fir/status/(open|closed))", [](const httplib::Request& req, httplib::Response& res) {
         std::string status = req.matches[1];
+        auto lock = firStore.readLock();
         auto records = firStore.listByStatus(status);
 
         Json::Value response;
@@ -166,20 +342,246 @@ int main() {
         res.set_content(Json::writeString(builder, response), "application/json");
     });
 
-    // GET /api/fir/stats
+    // POST /api/fir/query  {"where": <predicate>, "limit": n}
+    svr.Post("/api/fir/query", [](const httplib::Request& req, httplib::Response& res) {
+        Json::Value reqJson;
+        Json::Reader reader;
+        reader.parse(req.body, reqJson);
+
+        Json::Value response;
+        Predicate predicate;
+        std::string error;
+        if (!Predicate::parse(reqJson["where"], predicate, error)) {
+            response["success"] = false;
+            response["error"] = error;
+        } else {
+            std::vector<std::string> plan;
+            auto lock = firStore.readLock();
+            auto records = firStore.query(predicate, plan);
+            int limit = reqJson["limit"].isInt() ? reqJson["limit"].asInt() : 100;
+            limit = std::max(0, std::min(limit, 1000));
+            size_t count = records.size();
+            if (records.size() > static_cast<size_t>(limit)) records.resize(limit);
+
+            Json::Value planArray(Json::arrayValue);
+            for (const auto& step : plan) {
+                planArray.append(step);
+            }
+            response["success"] = true;
+            response["count"] = static_cast<Json::UInt64>(count);
+            response["records"] = recordsToJson(records);
+            response["plan"] = planArray;
+        }
+
+        Json::StreamWriterBuilder builder;
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_content(Json::writeString(builder, response), "application/json");
+    });
+
+    // GET /api/fir/stats?groupBy=status,district,month,section
     svr.Get("/api/fir/stats", [](const httplib::Request& req, httplib::Response& res) {
-        auto all = firStore.all();
-        int total = all.size();
-        int open = 0;
-        for (const auto* record : all) {
-            if (record->status == "open") open++;
+        auto lock = firStore.readLock();
+        const StatsCube& cube = firStore.statsCube();
+        auto countOf = [&cube](unsigned mask, const StatsCube::Key& key) -> Json::UInt64 {
+            auto it = cube.cuboid(mask).find(key);
+            return it != cube.cuboid(mask).end() ? it->second : 0;
+        };
+        const StatsCube::Key all{StatsCube::kAll, StatsCube::kAll, StatsCube::kAll, StatsCube::kAll};
+        auto statusCount = [&](const char* status) {
+            StatsCube::Key key = all;
+            key[StatsCube::Status] = InternedString(status).code();
+            return countOf(1u << StatsCube::Status, key);
+        };
+
+        Json::Value response;
+        response["success"] = true;
+        response["total"] = countOf(0, all);
+        response["open"] = statusCount("open");
+        response["closed"] = statusCount("closed");
+        response["under_investigation"] = statusCount("under_investigation");
+
+        // One-dimensional breakdowns
+        for (int d = 0; d < StatsCube::kDimensions; ++d) {
+            Json::Value counts(Json::objectValue);
+            for (const auto& cell : cube.cuboid(1u << d)) {
+                counts[cube.label(d, cell.first[d])] = static_cast<Json::UInt64>(cell.second);
+            }
+            std::string name = StatsCube::dimensionName(d);
+            name[0] = static_cast<char>(std::toupper(name[0]));
+            response["by" + name] = counts;
+        }
+
+        if (req.has_param("groupBy")) {
+            unsigned mask;
+            std::string error;
+            if (!StatsCube::parseGroupBy(req.get_param_value("groupBy"), mask, error)) {
+                response["success"] = false;
+                response["error"] = error;
+            } else {
+                Json::Value dims(Json::arrayValue);
+                for (int d = 0; d < StatsCube::kDimensions; ++d) {
+                    if (mask >> d & 1) dims.append(StatsCube::dimensionName(d));
+                }
+                Json::Value cells(Json::arrayValue);
+                for (const auto& cell : cube.cuboid(mask)) {
+                    Json::Value item;
+                    for (int d = 0; d < StatsCube::kDimensions; ++d) {
+                        if (mask >> d & 1) item[StatsCube::dimensionName(d)] = cube.label(d, cell.first[d]);
+                    }
+                    item["count"] = static_cast<Json::UInt64>(cell.second);
+                    cells.append(item);
+                }
+                response["groupBy"] = dims;
+                response["cells"] = cells;
+            }
         }
 
+        Json::StreamWriterBuilder builder;
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_content(Json::writeString(builder, response), "application/json");
+    });
+
+    // PUT /api/fir/:id/status  {"status": "closed"}
+    svr.Put(R"(/api/fir/(\d+)/status)", [](const httplib::Request& req, httplib::Response& res) {
+        int id = std::stoi(req.matches[1]);
+        Json::Value reqJson;
+        Json::Reader reader;
+        reader.parse(req.body, reqJson);
+        if (rejectRequest(reqJson, res)) return;
+
         Json::Value response;
+        auto lock = firStore.writeLock();
+        FIRRecord* record = firStore.setStatus(id, InternedString(reqJson.get("status", "open").asString()));
+        if (record) {
+            response["success"] = true;
+            response["record"] = record->toJson();
+        } else {
+            response["success"] = false;
+            response["error"] = "FIR not found";
+        }
+
+        Json::StreamWriterBuilder builder;
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_content(Json::writeString(builder, response), "application/json");
+    });
+
+    // PUT /api/fir/:id  full replacement, same body as create
+    svr.Put(R"(/api/fir/(\d+))", [](const httplib::Request& req, httplib::Response& res) {
+        int id = std::stoi(req.matches[1]);
+        Json::Value reqJson;
+        Json::Reader reader;
+        reader.parse(req.body, reqJson);
+        if (rejectRequest(reqJson, res)) return;
+
+        Json::Value response;
+        auto lock = firStore.writeLock();
+        FIRRecord* record = firStore.update(id, FIRRecord::fromJson(reqJson));
+        if (record) {
+            response["success"] = true;
+            response["record"] = record->toJson();
+        } else {
+            response["success"] = false;
+            response["error"] = "FIR not found";
+        }
+
+        Json::StreamWriterBuilder builder;
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_content(Json::writeString(builder, response), "application/json");
+    });
+
+    // PATCH /api/fir/:id  only the fields present in the body change
+    svr.Patch(R"(/api/fir/(\d+))", [](const httplib::Request& req, httplib::Response& res) {
+        int id = std::stoi(req.matches[1]);
+        Json::Value reqJson;
+        Json::Reader reader;
+        reader.parse(req.body, reqJson);
+        if (rejectRequest(reqJson, res)) return;
+
+        Json::Value response;
+        auto lock = firStore.writeLock();
+        FIRRecord* record = firStore.patch(id, [&reqJson](FIRRecord& target) {
+            target.applyJson(reqJson);
+        });
+        if (record) {
+            response["success"] = true;
+            response["record"] = record->toJson();
+        } else {
+            response["success"] = false;
+            response["error"] = "FIR not found";
+        }
+
+        Json::StreamWriterBuilder builder;
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_content(Json::writeString(builder, response), "application/json");
+    });
+
+    // DELETE /api/fir/:id
+    svr.Delete(R"(/api/fir/(\d+))", [](const httplib::Request& req, httplib::Response& res) {
+        int id = std::stoi(req.matches[1]);
+
+        Json::Value response;
+        auto lock = firStore.writeLock();
+        if (firStore.remove(id)) {
+            response["success"] = true;
+            response["id"] = id;
+        } else {
+            response["success"] = false;
+            response["error"] = "FIR not found";
+        }
+
+        Json::StreamWriterBuilder builder;
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_content(Json::writeString(builder, response), "application/json");
+    });
+
+    // GET /api/analytics/top?field=suspects|locations|sections&k=20&month=YYYY-MM
+    svr.Get("/api/analytics/top", [](const httplib::Request& req, httplib::Response& res) {
+        auto lock = firStore.readLock();
+        const FIRSketches& sketches = firStore.analyticsSketches();
+        int k = 20;
+        if (req.has_param("k")) k = std::atoi(req.get_param_value("k").c_str());
+        k = std::max(1, std::min(k, 100));
+
+        Json::Value response;
+        int32_t month = -1;
+        int32_t day;
+        if (req.has_param("month") &&
+            !CivilDate::parse(req.get_param_value("month") + "-01", day, month)) {
+            response["success"] = false;
+            response["error"] = "month must be YYYY-MM";
+            res.set_header("Access-Control-Allow-Origin", "*");
+            res.set_content(Json::writeString(Json::StreamWriterBuilder(), response), "application/json");
+            return;
+        }
+        const FIRSketches::Window* window = sketches.window(month);
+
+        static const char* fields[] = {"suspects", "locations", "sections"};
+        std::string only = req.has_param("field") ? req.get_param_value("field") : "";
+        Json::Value top(Json::objectValue);
+        for (int f = 0; f < FIRSketches::kFields; ++f) {
+            if (!only.empty() && only != fields[f]) continue;
+            Json::Value items(Json::arrayValue);
+            if (window) {
+                for (const auto& item : window->top[f].top(static_cast<size_t>(k))) {
+                    Json::Value entry;
+                    entry["key"] = item.key;
+                    entry["count"] = static_cast<Json::UInt64>(item.count);
+                    entry["maxError"] = static_cast<Json::UInt64>(item.error);
+                    items.append(entry);
+                }
+            }
+            top[fields[f]] = items;
+        }
+
+        Json::Value distinct(Json::objectValue);
+        for (const auto& entry : sketches.distinctComplainants()) {
+            distinct[entry.first.empty() ? "unknown" : entry.first] =
+                static_cast<Json::UInt64>(std::llround(entry.second.estimate()));
+        }
+
         response["success"] = true;
-        response["total"] = total;
-        response["open"] = open;
-        response["closed"] = total - open;
+        response["top"] = top;
+        response["distinctComplainantsByDistrict"] = distinct;
 
         Json::StreamWriterBuilder builder;
         res.set_header("Access-Control-Allow-Origin", "*");
@@ -189,7 +591,8 @@ int main() {
     // GET /api/ipc/search/:keyword
     svr.Get(R"(/api/ipc/search/(.+))", [](const httplib::Request& req, httplib::Response& res) {
         std::string keyword = req.matches[1];
-        auto sections = ipcStore.searchByKeyword(keyword);
+        IPCStore::Snapshot catalog = ipcStore.current();
+        auto sections = catalog->searchByKeyword(keyword);
 
         Json::Value response;
         response["success"] = true;
@@ -200,31 +603,93 @@ int main() {
         res.set_content(Json::writeString(builder, response), "application/json");
     });
 
-    // GET /api/ipc/all
-    svr.Get("/api/ipc/all", [](const httplib::Request& req, httplib::Response& res) {
-        auto sections = ipcStore.getAll();
+    // POST /api/ipc/suggest
+    svr.Post("/api/ipc/suggest", [](const httplib::Request& req, httplib::Response& res) {
+        Json::Value reqJson;
+        Json::Reader reader;
+        reader.parse(req.body, reqJson);
+
+        std::string description = reqJson["description"].asString();
+        int limit = std::max(1, std::min(reqJson.get("limit", 5).asInt(), 20));
 
+        IPCStore::Snapshot catalog = ipcStore.current();
         Json::Value response;
         response["success"] = true;
-        response["sections"] = sectionsToJson(sections);
+        response["sections"] = matchesToJson(catalog->suggestSections(description, static_cast<size_t>(limit)));
 
         Json::StreamWriterBuilder builder;
         res.set_header("Access-Control-Allow-Origin", "*");
         res.set_content(Json::writeString(builder, response), "application/json");
     });
 
-    // Load sample data
-    svr.Post("/api/fir/load-sample", [](const httplib::Request& req, httplib::Response& res) {
-        // Sample FIR records
-        FIRRecord* r1 = new FIRRecord{1, "Alice Johnson", "Bob Lee", "2025-11-01", "Downtown", "Theft at shop", "open", {"theft"}, {2}};
-        FIRRecord* r2 = new FIRRecord{2, "Carlos Mendez", "Unknown", "2025-10-15", "Uptown", "Vandalism", "closed", {"vandalism"}, {1}};
-        FIRRecord* r3 = new FIRRecord{3, "John Doe", "Bob Lee", "2025-09-20", "Downtown", "Assault", "open", {"assault"}, {}};
-        FIRRecord* r4 = new FIRRecord{4, "Jane Smith", "Samuel K", "2025-08-11", "West End", "Lost property", "open", {"lost"}, {}};
+    // GET /api/ipc/all
+    svr.Get("/api/ipc/all", [](const httplib::Request&, httplib::Response& res) {
+        res.set_header("Access-Control-Allow-Origin", "*");
+        IPCStore::Snapshot catalog = ipcStore.current();
+        res.set_content(catalog->allSectionsJson(), "application/json");
+    });
 
-        firStore.add(r1);
-        firStore.add(r2);
-        firStore.add(r3);
-        firStore.add(r4);
+    // GET /api/ipc/section/:section?act=IPC
+    svr.Get(R"(/api/ipc/section/([^/]+))", [](const httplib::Request& req, httplib::Response& res) {
+        std::string sec = req.matches[1];
+        std::string act = req.has_param("act") ? req.get_param_value("act") : "IPC";
+        IPCStore::Snapshot catalog = ipcStore.current();
+        const IPCSection* section = catalog->getBySection(sec, act);
+
+        Json::Value response;
+        if (section) {
+            response["success"] = true;
+            response["section"] = toJson(*section);
+        } else {
+            response["success"] = false;
+            response["message"] = "Section not found";
+        }
+
+        Json::StreamWriterBuilder builder;
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_content(Json::writeString(builder, response), "application/json");
+    });
+
+    // POST /api/ipc/reload - rebuild the catalog from its data file now
+    svr.Post("/api/ipc/reload", [](const httplib::Request&, httplib::Response& res) {
+        std::string error;
+        Json::Value response;
+        response["success"] = ipcStore.reload(error);
+        if (!error.empty()) {
+            response["message"] = error;
+        } else {
+            response["version"] = static_cast<Json::UInt64>(ipcStore.current()->version());
+            response["sectionCount"] = static_cast<Json::UInt64>(ipcStore.current()->size());
+        }
+
+        Json::StreamWriterBuilder builder;
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_content(Json::writeString(builder, response), "application/json");
+    });
+
+    // Load sample data
+    svr.Post("/api/fir/load-sample", [](const httplib::Request&, httplib::Response& res) {
+        // Sample FIR records; fields not listed here keep their defaults
+        auto sample = [](int id, const char* complainant, const char* suspect, const char* date,
+                         const char* location, const char* description, const char* status,
+                         std::vector<std::string> tags, std::vector<int> relatedIds) {
+            FIRRecord record;
+            record.id = id;
+            record.complainant = complainant;
+            record.suspect = suspect;
+            record.date = date;
+            record.location = location;
+            record.description = description;
+            record.status = status;
+            record.tags = std::move(tags);
+            record.relatedIds = std::move(relatedIds);
+            return record;
+        };
+        auto lock = firStore.writeLock();
+        firStore.add(sample(1, "Alice Johnson", "Bob Lee", "2025-11-01", "Downtown", "Theft at shop", "open", {"theft"}, {2}));
+        firStore.add(sample(2, "Carlos Mendez", "Unknown", "2025-10-15", "Uptown", "Vandalism", "closed", {"vandalism"}, {1}));
+        firStore.add(sample(3, "John Doe", "Bob Lee", "2025-09-20", "Downtown", "Assault", "open", {"assault"}, {}));
+        firStore.add(sample(4, "Jane Smith", "Samuel K", "2025-08-11", "West End", "Lost property", "open", {"lost"}, {}));
 
         Json::Value response;
         response["success"] = true;
@@ -235,6 +700,10 @@ int main() {
         res.set_content(Json::writeString(builder, response), "application/json");
     });
 
+    // Law catalog data file, hot-reloaded when it changes on disk
+    const char* catalogPath = std::getenv("IPC_CATALOG_PATH");
+    ipcStore.watch(catalogPath ? catalogPath : "../ipc_catalog.json", std::chrono::seconds(2));
+
     std::cout << "FIR Backend Server starting on http://localhost:8080" << std::endl;
     svr.listen("0.0.0.0", 8080);
 
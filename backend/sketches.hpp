@@ -0,0 +1,191 @@
+#ifndef SKETCHES_HPP
+#define SKETCHES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+inline uint64_t sketchHash(std::string_view text) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char ch : text) {
+        h = (h ^ ch) * 1099511628211ULL;
+    }
+    // splitmix64 finalizer so the high bits are well mixed too
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+// Space-Saving heavy hitters with a fixed number of counters. Any key whose
+// true frequency exceeds n / capacity is guaranteed to be tracked; each
+// reported count overestimates by at most its error field.
+//
+// Counters sit in an array sorted by count, with the last index of every
+// count value remembered. Incrementing swaps the counter to the end of its
+// run and bumps it, which keeps the order, so updates are O(1) and the
+// minimum (the eviction victim) is always slot 0. Only the first
+// `capacity` distinct keys pay an O(capacity) insert while the array fills.
+class SpaceSaving {
+public:
+    struct Item {
+        std::string key;
+        uint64_t count;
+        uint64_t error;
+    };
+
+private:
+    size_t capacity;
+    std::vector<Item> items;                       // ascending by count
+    std::unordered_map<std::string, size_t> slotOf;
+    std::unordered_map<uint64_t, size_t> lastOfCount; // count -> last slot with it
+
+    void increment(size_t i) {
+        uint64_t c = items[i].count;
+        size_t j = lastOfCount[c];
+        if (i != j) {
+            std::swap(items[i], items[j]);
+            slotOf[items[i].key] = i;
+            slotOf[items[j].key] = j;
+        }
+        // j leaves the run of c and becomes the first of c + 1
+        if (j > 0 && items[j - 1].count == c) lastOfCount[c] = j - 1;
+        else lastOfCount.erase(c);
+        items[j].count = c + 1;
+        if (!lastOfCount.count(c + 1)) lastOfCount[c + 1] = j;
+    }
+
+public:
+    explicit SpaceSaving(size_t counters = 256) : capacity(counters) {}
+
+    void add(const std::string& key) {
+        if (key.empty()) return;
+        auto it = slotOf.find(key);
+        if (it != slotOf.end()) {
+            increment(it->second);
+            return;
+        }
+        if (items.size() < capacity) {
+            // New keys start at 1, which sorts before everything else
+            items.insert(items.begin(), Item{key, 0, 0});
+            for (size_t i = 0; i < items.size(); ++i) slotOf[items[i].key] = i;
+            for (auto& entry : lastOfCount) entry.second++;
+            lastOfCount[0] = 0;
+            increment(0);
+            return;
+        }
+        // Replace the minimum; the newcomer inherits its count as error
+        slotOf.erase(items[0].key);
+        items[0].key = key;
+        items[0].error = items[0].count;
+        slotOf[key] = 0;
+        increment(0);
+    }
+
+    std::vector<Item> top(size_t k) const {
+        std::vector<Item> out;
+        for (size_t i = items.size(); i-- > 0 && out.size() < k;) {
+            out.push_back(items[i]);
+        }
+        return out;
+    }
+};
+
+// HyperLogLog distinct counter, 2^precision one-byte registers
+// (4 KB at the default precision, ~1.6% standard error).
+class HyperLogLog {
+private:
+    uint8_t precision;
+    std::vector<uint8_t> registers;
+
+public:
+    explicit HyperLogLog(uint8_t p = 12) : precision(p), registers(size_t(1) << p, 0) {}
+
+    void add(std::string_view value) {
+        uint64_t h = sketchHash(value);
+        size_t index = h >> (64 - precision);
+        uint64_t rest = h << precision;
+        uint8_t rank = rest ? static_cast<uint8_t>(__builtin_clzll(rest) + 1)
+                            : static_cast<uint8_t>(64 - precision + 1);
+        registers[index] = std::max(registers[index], rank);
+    }
+
+    double estimate() const {
+        double m = static_cast<double>(registers.size());
+        double sum = 0;
+        size_t zeros = 0;
+        for (uint8_t r : registers) {
+            sum += std::ldexp(1.0, -r);
+            zeros += r == 0;
+        }
+        double alpha = 0.7213 / (1.0 + 1.079 / m);
+        double raw = alpha * m * m / sum;
+        if (raw <= 2.5 * m && zeros) {
+            return m * std::log(m / zeros); // linear counting for small sets
+        }
+        return raw;
+    }
+};
+
+// Streaming top-k and distinct counts for the analytics endpoints. Each
+// window (all time, plus the most recent months by incident date) holds one
+// Space-Saving sketch per field; memory is bounded by windows x counters.
+class FIRSketches {
+public:
+    enum Field { Suspect = 0, Location = 1, Section = 2, kFields = 3 };
+
+    struct Window {
+        SpaceSaving top[kFields];
+    };
+
+private:
+    static constexpr size_t kMonthsKept = 12;
+
+    Window allTime;
+    std::map<int32_t, Window> months; // year * 12 + month - 1
+    std::unordered_map<std::string, HyperLogLog> complainantsByDistrict;
+
+public:
+    // month < 0 when the record has no usable date
+    void add(int32_t month, const std::string& suspect, const std::string& location,
+             const std::vector<std::string>& sections, const std::string& district,
+             const std::string& complainant) {
+        Window* windows[2] = {&allTime, nullptr};
+        // Keep the newest kMonthsKept months; older incidents count all-time only
+        if (month >= 0 && (months.count(month) || months.size() < kMonthsKept ||
+                           month > months.begin()->first)) {
+            windows[1] = &months[month];
+            if (months.size() > kMonthsKept) months.erase(months.begin());
+        }
+        for (Window* window : windows) {
+            if (!window) continue;
+            window->top[Suspect].add(suspect);
+            window->top[Location].add(location);
+            for (const auto& section : sections) window->top[Section].add(section);
+        }
+        if (!complainant.empty()) {
+            complainantsByDistrict[district].add(complainant);
+        }
+    }
+
+    // All-time window, or one month; null if that month is not kept
+    const Window* window(int32_t month = -1) const {
+        if (month < 0) return &allTime;
+        auto it = months.find(month);
+        return it != months.end() ? &it->second : nullptr;
+    }
+
+    const std::unordered_map<std::string, HyperLogLog>& distinctComplainants() const {
+        return complainantsByDistrict;
+    }
+};
+
+#endif // SKETCHES_HPP
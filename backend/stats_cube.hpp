@@ -0,0 +1,135 @@
+#ifndef STATS_CUBE_HPP
+#define STATS_CUBE_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "fir_record.hpp"
+#include "civil_date.hpp"
+
+// Pre-aggregated FIR counts over status x district x month x IPC section.
+// Every group-by (each subset of the four dimensions, 16 cuboids) is kept
+// as its own map of cells and updated on every add/remove, so answering a
+// stats query only reads the cells of one cuboid.
+//
+// A FIR with several sections counts once per section in cuboids that
+// group by section, and once in all others. FIRs without sections fall
+// under the empty section. Districts are keyed by their code in the
+// owning store's dictionary, which outlives every cell naming it.
+class StatsCube {
+public:
+    enum Dimension { Status = 0, District = 1, Month = 2, Section = 3, kDimensions = 4 };
+
+    static constexpr uint32_t kUnknownMonth = UINT32_MAX - 1;
+    static constexpr uint32_t kAll = UINT32_MAX; // dimension not grouped
+
+    using Key = std::array<uint32_t, kDimensions>;
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            uint64_t h = 1469598103934665603ULL;
+            for (uint32_t part : key) {
+                h = (h ^ part) * 1099511628211ULL;
+            }
+            return static_cast<size_t>(h);
+        }
+    };
+
+    using Cuboid = std::unordered_map<Key, uint64_t, KeyHash>;
+
+private:
+    std::array<Cuboid, 1 << kDimensions> cuboids;
+    const CountedDictionary& districts;
+
+    static uint32_t monthOf(const std::string& date) {
+        int32_t day, month;
+        if (!CivilDate::parse(date, day, month) || month < 0) return kUnknownMonth;
+        return static_cast<uint32_t>(month);
+    }
+
+    void bump(unsigned mask, const Key& full, long delta) {
+        Key key;
+        for (int d = 0; d < kDimensions; ++d) {
+            key[d] = (mask >> d & 1) ? full[d] : kAll;
+        }
+        Cuboid& cuboid = cuboids[mask];
+        auto it = cuboid.find(key);
+        if (delta > 0) {
+            if (it == cuboid.end()) it = cuboid.emplace(key, 0).first;
+            it->second += static_cast<uint64_t>(delta);
+        } else if (it != cuboid.end()) {
+            it->second -= static_cast<uint64_t>(-delta);
+            if (it->second == 0) cuboid.erase(it);
+        }
+    }
+
+public:
+    explicit StatsCube(const CountedDictionary& districtCodes) : districts(districtCodes) {}
+
+    // Count a record in (delta = 1) or out (delta = -1) of every cuboid;
+    // district is the record's district code
+    void add(const FIRRecord& record, uint32_t district, long delta) {
+        Key full{record.status.code(), district, monthOf(record.date), 0};
+        for (unsigned mask = 0; mask < cuboids.size(); ++mask) {
+            if (!(mask >> Section & 1)) {
+                bump(mask, full, delta);
+                continue;
+            }
+            if (record.ipcSections.empty()) {
+                full[Section] = 0; // intern id of ""
+                bump(mask, full, delta);
+            }
+            for (const auto& section : record.ipcSections) {
+                full[Section] = section.code();
+                bump(mask, full, delta);
+            }
+        }
+    }
+
+    const Cuboid& cuboid(unsigned mask) const {
+        return cuboids[mask];
+    }
+
+    // "status,month" -> dimension mask; false on an unknown name
+    static bool parseGroupBy(const std::string& spec, unsigned& mask, std::string& error) {
+        mask = 0;
+        size_t start = 0;
+        while (start <= spec.size()) {
+            size_t end = spec.find(',', start);
+            if (end == std::string::npos) end = spec.size();
+            std::string name = spec.substr(start, end - start);
+            if (name == "status") mask |= 1u << Status;
+            else if (name == "district") mask |= 1u << District;
+            else if (name == "month") mask |= 1u << Month;
+            else if (name == "section" || name == "ipcSection") mask |= 1u << Section;
+            else if (!name.empty()) {
+                error = "unknown groupBy dimension '" + name + "'";
+                return false;
+            }
+            start = end + 1;
+        }
+        return true;
+    }
+
+    static const char* dimensionName(int d) {
+        static const char* names[] = {"status", "district", "month", "section"};
+        return names[d];
+    }
+
+    // Text of one key component; missing values read as "unknown"
+    std::string label(int d, uint32_t value) const {
+        if (d == Month) {
+            if (value == kUnknownMonth) return "unknown";
+            char text[16];
+            std::snprintf(text, sizeof(text), "%04u-%02u", value / 12, value % 12 + 1);
+            return text;
+        }
+        std::string_view text = d == District ? districts.lookup(value) : internTable().lookup(value);
+        return text.empty() ? "unknown" : std::string(text);
+    }
+};
+
+#endif // STATS_CUBE_HPP
@@ -0,0 +1,166 @@
+#ifndef TEXT_SEARCH_HPP
+#define TEXT_SEARCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TEXT_SEARCH_X86 1
+#endif
+
+// ASCII case-insensitive substring search over stored text, without
+// lowercasing a copy of the haystack.
+//
+// The SIMD kernels use first/last-byte filtering: compare a block of
+// haystack bytes against the needle's first byte, compare the block
+// n-1 bytes later against its last byte, AND the two masks, and only
+// verify the middle of the needle at the surviving positions. Case is
+// folded by OR-ing 0x20 into the haystack when the needle byte is a
+// letter; no non-letter byte folds onto a lowercase letter, so the
+// filter is exact. AVX2 is picked at runtime when the CPU has it, SSE2
+// otherwise on x86, and the scalar loop everywhere else.
+class CaseInsensitiveMatcher {
+public:
+    enum class Kernel { Scalar, SSE2, AVX2 };
+
+private:
+    std::string needle; // lowercased
+    uint8_t first = 0, last = 0;
+    uint8_t firstFold = 0, lastFold = 0; // 0x20 if the byte is a letter
+    Kernel kernel;
+
+    static uint8_t lower(uint8_t c) {
+        return static_cast<uint8_t>(c + ((static_cast<uint8_t>(c - 'A') < 26u) << 5));
+    }
+
+    static bool isLetter(uint8_t c) {
+        return static_cast<uint8_t>((c | 0x20) - 'a') < 26u;
+    }
+
+    // Does haystack[pos, pos + n) match the needle, ignoring case?
+    bool verify(const char* text, size_t pos) const {
+        const uint8_t* h = reinterpret_cast<const uint8_t*>(text) + pos;
+        for (size_t k = 0; k < needle.size(); ++k) {
+            if (lower(h[k]) != static_cast<uint8_t>(needle[k])) return false;
+        }
+        return true;
+    }
+
+    size_t findScalar(const char* text, size_t size, size_t from) const {
+        size_t n = needle.size();
+        for (size_t i = from; i + n <= size; ++i) {
+            if (lower(static_cast<uint8_t>(text[i])) == first &&
+                lower(static_cast<uint8_t>(text[i + n - 1])) == last &&
+                verify(text, i)) {
+                return i;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+#ifdef TEXT_SEARCH_X86
+    size_t findSSE2(const char* text, size_t size) const {
+        size_t n = needle.size();
+        const __m128i firstVec = _mm_set1_epi8(static_cast<char>(first));
+        const __m128i lastVec = _mm_set1_epi8(static_cast<char>(last));
+        const __m128i firstFoldVec = _mm_set1_epi8(static_cast<char>(firstFold));
+        const __m128i lastFoldVec = _mm_set1_epi8(static_cast<char>(lastFold));
+
+        size_t i = 0;
+        for (; i + n - 1 + 16 <= size; i += 16) {
+            __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+            __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + n - 1));
+            __m128i eqFirst = _mm_cmpeq_epi8(_mm_or_si128(blockFirst, firstFoldVec), firstVec);
+            __m128i eqLast = _mm_cmpeq_epi8(_mm_or_si128(blockLast, lastFoldVec), lastVec);
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(eqFirst, eqLast)));
+            while (mask) {
+                size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+                if (verify(text, pos)) return pos;
+                mask &= mask - 1;
+            }
+        }
+        return findScalar(text, size, i);
+    }
+
+    __attribute__((target("avx2")))
+    size_t findAVX2(const char* text, size_t size) const {
+        size_t n = needle.size();
+        const __m256i firstVec = _mm256_set1_epi8(static_cast<char>(first));
+        const __m256i lastVec = _mm256_set1_epi8(static_cast<char>(last));
+        const __m256i firstFoldVec = _mm256_set1_epi8(static_cast<char>(firstFold));
+        const __m256i lastFoldVec = _mm256_set1_epi8(static_cast<char>(lastFold));
+
+        size_t i = 0;
+        for (; i + n - 1 + 32 <= size; i += 32) {
+            __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+            __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + n - 1));
+            __m256i eqFirst = _mm256_cmpeq_epi8(_mm256_or_si256(blockFirst, firstFoldVec), firstVec);
+            __m256i eqLast = _mm256_cmpeq_epi8(_mm256_or_si256(blockLast, lastFoldVec), lastVec);
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(eqFirst, eqLast)));
+            while (mask) {
+                size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+                if (verify(text, pos)) return pos;
+                mask &= mask - 1;
+            }
+        }
+        return findScalar(text, size, i);
+    }
+#endif
+
+public:
+    static Kernel bestKernel() {
+#ifdef TEXT_SEARCH_X86
+        static const Kernel best = __builtin_cpu_supports("avx2") ? Kernel::AVX2 : Kernel::SSE2;
+        return best;
+#else
+        return Kernel::Scalar;
+#endif
+    }
+
+    static const char* kernelName(Kernel k) {
+        switch (k) {
+            case Kernel::AVX2: return "avx2";
+            case Kernel::SSE2: return "sse2";
+            default: return "scalar";
+        }
+    }
+
+    explicit CaseInsensitiveMatcher(std::string_view pattern, Kernel k = bestKernel())
+        : needle(pattern), kernel(k) {
+        for (char& c : needle) c = static_cast<char>(lower(static_cast<uint8_t>(c)));
+        if (!needle.empty()) {
+            first = static_cast<uint8_t>(needle.front());
+            last = static_cast<uint8_t>(needle.back());
+            firstFold = isLetter(first) ? 0x20 : 0;
+            lastFold = isLetter(last) ? 0x20 : 0;
+        }
+#ifndef TEXT_SEARCH_X86
+        kernel = Kernel::Scalar;
+#endif
+    }
+
+    // Offset of the first match in text, or npos
+    size_t find(std::string_view text) const {
+        if (needle.empty()) return 0;
+        if (needle.size() > text.size()) return std::string_view::npos;
+#ifdef TEXT_SEARCH_X86
+        if (kernel == Kernel::AVX2) return findAVX2(text.data(), text.size());
+        if (kernel == Kernel::SSE2) return findSSE2(text.data(), text.size());
+#endif
+        return findScalar(text.data(), text.size(), 0);
+    }
+
+    bool matches(std::string_view text) const {
+        return find(text) != std::string_view::npos;
+    }
+
+    size_t size() const {
+        return needle.size();
+    }
+};
+
+#endif // TEXT_SEARCH_HPP
@@ -0,0 +1,109 @@
+/**
+ * Case-insensitive substring search benchmark
+ * Builds a synthetic corpus of FIR-like descriptions (2 GiB by default)
+ * and compares the old lowercase-copy + find scan against the scalar,
+ * SSE2 and AVX2 kernels in text_search.hpp.
+ *
+ * Compile: g++ -std=c++17 -O2 text_search_bench.cpp -o text_search_bench
+ * Run: ./text_search_bench [corpus MiB] [needle]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "text_search.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t corpusMiB = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2048;
+    std::string needle = argc > 2 ? argv[2] : "Stolen Motorcycle";
+
+    static const char* words[] = {
+        "the", "complainant", "reported", "that", "unknown", "persons", "entered",
+        "house", "at", "night", "and", "took", "gold", "chain", "mobile", "phone",
+        "Market", "Road", "near", "Station", "vehicle", "parked", "outside", "shop",
+        "threatened", "with", "knife", "cash", "stole", "motor", "cycle", "Sector"
+    };
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+
+    // Records of ~200-400 bytes laid end to end in one buffer
+    std::mt19937 rng(42);
+    std::string corpus;
+    corpus.reserve(corpusMiB << 20);
+    std::vector<std::pair<size_t, size_t>> records;
+    while (corpus.size() + 512 < (corpusMiB << 20)) {
+        size_t start = corpus.size();
+        size_t length = 200 + rng() % 200;
+        while (corpus.size() - start < length) {
+            corpus += words[rng() % wordCount];
+            corpus += ' ';
+        }
+        if (rng() % 1000 == 0) {
+            corpus += (rng() & 1) ? "STOLEN MOTORCYCLE " : "stolen motorcycle ";
+        }
+        records.emplace_back(start, corpus.size() - start);
+    }
+    std::cout << "Corpus: " << (corpus.size() >> 20) << " MiB in " << records.size()
+              << " records, needle \"" << needle << "\"" << std::endl;
+
+    auto report = [&](const char* name, double secs, size_t hits) {
+        std::cout << name << ": " << secs << " s, "
+                  << (corpus.size() / secs) / (1 << 30) << " GiB/s, "
+                  << hits << " matching records" << std::endl;
+    };
+
+    // Baseline: lowercase a copy of each record, then std::string::find
+    {
+        std::string lowerNeedle = needle;
+        std::transform(lowerNeedle.begin(), lowerNeedle.end(), lowerNeedle.begin(), ::tolower);
+        size_t hits = 0;
+        auto start = Clock::now();
+        for (const auto& record : records) {
+            std::string text = corpus.substr(record.first, record.second);
+            std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+            if (text.find(lowerNeedle) != std::string::npos) hits++;
+        }
+        report("tolower copy", secondsSince(start), hits);
+    }
+
+    const CaseInsensitiveMatcher::Kernel kernels[] = {
+        CaseInsensitiveMatcher::Kernel::Scalar,
+        CaseInsensitiveMatcher::Kernel::SSE2,
+        CaseInsensitiveMatcher::Kernel::AVX2
+    };
+    for (auto kernel : kernels) {
+        if (kernel == CaseInsensitiveMatcher::Kernel::AVX2 &&
+            CaseInsensitiveMatcher::bestKernel() != kernel) {
+            continue;
+        }
+        CaseInsensitiveMatcher matcher(needle, kernel);
+        size_t hits = 0;
+        auto start = Clock::now();
+        for (const auto& record : records) {
+            if (matcher.matches(std::string_view(corpus.data() + record.first, record.second))) hits++;
+        }
+        report(CaseInsensitiveMatcher::kernelName(kernel), secondsSince(start), hits);
+    }
+
+    // Whole-buffer scan, no record boundaries
+    CaseInsensitiveMatcher matcher(needle);
+    size_t occurrences = 0;
+    auto start = Clock::now();
+    std::string_view rest(corpus);
+    for (size_t pos; (pos = matcher.find(rest)) != std::string_view::npos; ) {
+        occurrences++;
+        rest.remove_prefix(pos + matcher.size());
+    }
+    report("contiguous", secondsSince(start), occurrences);
+    return 0;
+}
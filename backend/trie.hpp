@@ -26,7 +26,7 @@ class Trie {
 private:
     TrieNode* root;
 
-    std::string toLower(const std::string& str) {
+    static std::string toLower(const std::string& str) {
         std::string result = str;
         std::transform(result.begin(), result.end(), result.begin(), ::tolower);
         return result;
@@ -55,33 +55,74 @@ public:
         node->isEnd = true;
     }
 
-    std::vector<int> searchExact(const std::string& key) {
+    // Drop id from every node on key's path. Each node holds the ids of
+    // its whole subtree, so a node left without ids is pruned with its
+    // descendants.
+    void remove(const std::string& key, int id) {
         std::string lowerKey = toLower(key);
         TrieNode* node = root;
+
+        for (char ch : lowerKey) {
+            auto it = node->children.find(ch);
+            if (it == node->children.end()) {
+                return;
+            }
+            TrieNode* child = it->second;
+            child->ids.erase(id);
+            if (child->ids.empty()) {
+                node->children.erase(it);
+                delete child;
+                return;
+            }
+            node = child;
+        }
+    }
+
+    std::vector<int> searchExact(const std::string& key) const {
+        std::string lowerKey = toLower(key);
+        const TrieNode* node = root;
         
         for (char ch : lowerKey) {
-            if (node->children.find(ch) == node->children.end()) {
+            auto it = node->children.find(ch);
+            if (it == node->children.end()) {
                 return std::vector<int>();
             }
-            node = node->children[ch];
+            node = it->second;
         }
         
         return std::vector<int>(node->ids.begin(), node->ids.end());
     }
 
-    std::vector<int> startsWith(const std::string& prefix) {
+    std::vector<int> startsWith(const std::string& prefix) const {
         std::string lowerPrefix = toLower(prefix);
-        TrieNode* node = root;
+        const TrieNode* node = root;
         
         for (char ch : lowerPrefix) {
-            if (node->children.find(ch) == node->children.end()) {
+            auto it = node->children.find(ch);
+            if (it == node->children.end()) {
                 return std::vector<int>();
             }
-            node = node->children[ch];
+            node = it->second;
         }
         
         return std::vector<int>(node->ids.begin(), node->ids.end());
     }
+
+    // Number of ids under prefix, without collecting them
+    size_t countPrefix(const std::string& prefix) const {
+        std::string lowerPrefix = toLower(prefix);
+        const TrieNode* node = root;
+        
+        for (char ch : lowerPrefix) {
+            auto it = node->children.find(ch);
+            if (it == node->children.end()) {
+                return 0;
+            }
+            node = it->second;
+        }
+        
+        return node->ids.size();
+    }
 };
 
 #endif // TRIE_HPP
@@ -0,0 +1,108 @@
+#ifndef UNION_FIND_HPP
+#define UNION_FIND_HPP
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Disjoint-set forest over FIR ids with path halving and union by size.
+// Tracks component sizes in an ordered set so the largest clusters can be
+// listed without a traversal, and threads members of each component on a
+// circular list so a cluster can be enumerated in O(size).
+class UnionFind {
+private:
+    std::unordered_map<int, uint32_t> index; // FIR id -> dense id
+    std::vector<int> ids;                    // dense id -> FIR id
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> sizes;
+    std::vector<uint32_t> nextMember;        // circular list per component
+    std::set<std::pair<uint32_t, uint32_t>, std::greater<>> bySize; // (size, root)
+
+    uint32_t addDense(int id) {
+        auto it = index.find(id);
+        if (it != index.end()) return it->second;
+        uint32_t v = static_cast<uint32_t>(ids.size());
+        index.emplace(id, v);
+        ids.push_back(id);
+        parent.push_back(v);
+        sizes.push_back(1);
+        nextMember.push_back(v);
+        bySize.emplace(1, v);
+        return v;
+    }
+
+    uint32_t findRoot(uint32_t v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    }
+
+public:
+    void add(int id) {
+        addDense(id);
+    }
+
+    void unite(int a, int b) {
+        uint32_t ra = findRoot(addDense(a));
+        uint32_t rb = findRoot(addDense(b));
+        if (ra == rb) return;
+        if (sizes[ra] < sizes[rb]) std::swap(ra, rb);
+
+        bySize.erase({sizes[ra], ra});
+        bySize.erase({sizes[rb], rb});
+        parent[rb] = ra;
+        sizes[ra] += sizes[rb];
+        std::swap(nextMember[ra], nextMember[rb]);
+        bySize.emplace(sizes[ra], ra);
+    }
+
+    bool contains(int id) const {
+        return index.find(id) != index.end();
+    }
+
+    // FIR id of the cluster representative, or -1 if unknown
+    int clusterOf(int id) {
+        auto it = index.find(id);
+        return it == index.end() ? -1 : ids[findRoot(it->second)];
+    }
+
+    size_t clusterSize(int id) {
+        auto it = index.find(id);
+        return it == index.end() ? 0 : sizes[findRoot(it->second)];
+    }
+
+    std::vector<int> members(int id, size_t limit) {
+        std::vector<int> result;
+        auto it = index.find(id);
+        if (it == index.end()) return result;
+        uint32_t v = it->second;
+        uint32_t cur = v;
+        do {
+            if (result.size() >= limit) break;
+            result.push_back(ids[cur]);
+            cur = nextMember[cur];
+        } while (cur != v);
+        return result;
+    }
+
+    // (representative FIR id, size) for the k biggest clusters
+    std::vector<std::pair<int, size_t>> largest(size_t k) const {
+        std::vector<std::pair<int, size_t>> result;
+        for (const auto& entry : bySize) {
+            if (result.size() >= k) break;
+            result.emplace_back(ids[entry.second], entry.first);
+        }
+        return result;
+    }
+
+    size_t clusterCount() const {
+        return bySize.size();
+    }
+};
+
+#endif // UNION_FIND_HPP